@@ -0,0 +1,69 @@
+<?xml version="1.0" encoding="UTF-8"?>
+<tileset version="1.10" tiledversion="1.11.2" name="dungeon" tilewidth="16" tileheight="16">
+ <image source="Dungeon_16x16_asset_pack/tileset.png"/>
+ <tile id="0">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="1">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="2">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="3">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="4">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="5">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="6">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="7">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="8">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="12">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="13">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="14">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+ <tile id="26">
+  <properties>
+   <property name="collision" value="solid"/>
+  </properties>
+ </tile>
+</tileset>
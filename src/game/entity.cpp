@@ -31,6 +31,7 @@ Entity::Entity(SDL_Renderer* renderer, const char* sprite_path, int sprite_width
             spritesheet = nullptr;
         }
     }
+    validateAnimations();
 }
 
 Entity::~Entity() {
@@ -57,6 +58,7 @@ void Entity::setAnimations(int** new_animations) {
         delete[] animations;
     }
     animations = new_animations;
+    validateAnimations();
     // Reset animation state
     currentAnimation = 0;
     currentStage = 0;
@@ -91,10 +93,32 @@ void Entity::render(SDL_Renderer* renderer) {
     }
 
 
-    spritesheet->select_sprite(sprite_index);
+    // Frames were checked against the sheet by validateAnimations()
     SDL_RendererFlip flip = flipped ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-    // Draw using float coordinates for position
-    spritesheet->draw(renderer, x, y, spriteWidth, spriteHeight, flip);
+    SDL_Rect dest{static_cast<int>(x), static_cast<int>(y), spriteWidth, spriteHeight};
+    spritesheet->draw(renderer, sprite_index, dest, flip);
+}
+
+void Entity::validateAnimations() {
+    if (!spritesheet) return;
+    // Nothing to show at all
+    if (spritesheet->getFrameCount() == 0) {
+        std::cerr << "Warning: Spritesheet is smaller than one sprite." << std::endl;
+        delete spritesheet;
+        spritesheet = nullptr;
+        return;
+    }
+    if (!animations) return;
+    for (int a = 0; animations[a] != nullptr; ++a) {
+        for (int stage = 0; animations[a][stage] >= 0; ++stage) {
+            if (!spritesheet->isValidFrame(animations[a][stage])) {
+                std::cerr << "Warning: Animation " << a << " frame " << stage
+                          << " uses sprite " << animations[a][stage] << ", the sheet has "
+                          << spritesheet->getFrameCount() << "; showing sprite 0." << std::endl;
+                animations[a][stage] = 0;
+            }
+        }
+    }
 }
 
 SDL_Point Entity::getPosition() const {
@@ -189,6 +213,7 @@ void Entity::setSpriteSheet(Spritesheet* sheet) {
         delete spritesheet;
     }
     spritesheet = sheet;
+    validateAnimations();
 }
 
 void Entity::setSpriteSize(int width, int height) {
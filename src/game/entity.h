@@ -1,6 +1,7 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include "utils/spritesheet.h"
+#include "utils/audio.h" // For SoundSource
 #include "utils/tilemap.h" // Include Tilemap for the update signature
 #include "utils/collisions_defs.h" // Include collision definitions
 
@@ -39,6 +40,9 @@ public:
     CollisionLayer layer = CollisionLayer::NONE; // What this entity IS
     CollisionLayer mask = CollisionLayer::NONE;  // What this entity COLLIDES WITH
 
+    // Sounds played from here follow the entity; kept at its centre by the EntityManager
+    SoundSource sound;
+
 protected:
     Spritesheet* spritesheet;
     int currentStage;
@@ -47,4 +51,8 @@ protected:
     int** animations; // Consider std::vector<std::vector<int>>
 
     bool markedForDeletion;
+
+    // Checks every animation frame against the sheet when either changes,
+    // so render() can draw without checking. Bad frames become frame 0.
+    void validateAnimations();
 };
@@ -9,6 +9,26 @@ void EntityManager::setScreenDimensions(int width, int height) {
 }
 
 void EntityManager::update(Tilemap* map, float time, float deltaTime) {
+    // 0. Refresh line-of-sight data once for everyone
+    visibility.beginFrame(map);
+    Player* player = getPlayer();
+    if (player && !player->isMarkedForDeletion()) {
+        // Precompute who can see the player (16 tiles ~ Geezer sight range),
+        // using what blocks enemy fireballs as the sight mask
+        visibility.setTarget(
+            player->x, player->y, CollisionLayer::MASK_ENEMY_PROJECTILE, 16
+        );
+    }
+
+    // Sounds are heard from the player, or the middle of the screen without one
+    if (player && !player->isMarkedForDeletion()) {
+        VoiceManager::setListener(
+            player->x + player->spriteWidth / 2.0f, player->y + player->spriteHeight / 2.0f
+        );
+    } else {
+        VoiceManager::setListener(screenWidth / 2.0f, screenHeight / 2.0f);
+    }
+
     // 1. Update all active entities (handles movement, AI, animation)
     for (auto& entity : entities) {
         if (entity && !entity->isMarkedForDeletion()) {
@@ -25,6 +45,11 @@ void EntityManager::update(Tilemap* map, float time, float deltaTime) {
             continue;
         }
 
+        // Sound sources sit at the sprite's centre
+        entity->sound.setPosition(
+            entity->x + entity->spriteWidth / 2.0f, entity->y + entity->spriteHeight / 2.0f
+        );
+
         // Example: Remove off-screen fireballs
         if (auto* fb = dynamic_cast<Fireball*>(entity.get())) {
             if (fb->isOffScreen(screenWidth, screenHeight)) {
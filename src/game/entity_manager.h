@@ -11,6 +11,7 @@
 #include "player.h"   // Include specific types if needed for helpers
 #include "fireball.h" // Include specific types if needed for helpers
 #include "utils/tilemap.h"
+#include "utils/visibility.h"
 #include "utils/collisions_defs.h" // Include collision definitions
 
 class EntityManager {
@@ -45,11 +46,16 @@ public:
 
     void setScreenDimensions(int width, int height);
 
+    // Shared line-of-sight cache for AI. Refreshed at the start of update(),
+    // with the player's visible set precomputed.
+    VisibilityService& getVisibility() { return visibility; }
+
 private:
     SDL_Renderer* renderer; // Store renderer if needed by entities
     std::vector<std::unique_ptr<Entity>> entities;
     int screenWidth = 640;
     int screenHeight = 480;
+    VisibilityService visibility;
 
     // Collision handling logic
     void handleCollisions();
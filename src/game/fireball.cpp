@@ -36,22 +36,30 @@ Fireball::Fireball(
 }
 
 void Fireball::update(Tilemap* map, float time, float deltaTime) {
-    // Basic movement - no tile collision check for fireballs yet
-    // A more robust system might check tile collisions based on the mask
-    float proposedX = x + vx * deltaTime;
-    float proposedY = y + vy * deltaTime;
+    // Sweep the box along this frame's movement so fast fireballs can't
+    // skip over thin walls between frames
+    float moveX = vx * deltaTime;
+    float moveY = vy * deltaTime;
 
-    // Check tile collision (optional for fireballs, depends on game design)
-    SDL_FRect proposedBox = {proposedX - spriteWidth / 2.0f, proposedY - spriteHeight / 2.0f, (float)spriteWidth, (float)spriteHeight};
-    if (map->checkCollision(proposedBox, mask)) {
+    // Out in the open nothing is close enough to hit this frame: the box
+    // can't reach further than its half-diagonal plus the move
+    float reach = std::sqrt(moveX * moveX + moveY * moveY) +
+                  0.5f * std::sqrt(static_cast<float>(spriteWidth * spriteWidth + spriteHeight * spriteHeight));
+    bool nearWalls = map->getDistanceField(mask).clearance(x, y) <= reach;
+
+    SweepHit sweep;
+    if (nearWalls) sweep = map->sweepBox(getBoundingBox(), moveX, moveY, mask);
+    if (sweep.hit) {
         // Fireball hit a wall/obstacle it cares about
+        x += moveX * sweep.time; // Stop at the point of impact
+        y += moveY * sweep.time;
         markForDeletion(); // Destroy the fireball
         return; // Stop further updates this frame
     }
 
     // If no collision, update position
-    x = proposedX;
-    y = proposedY;
+    x += moveX;
+    y += moveY;
 
 
     // Advance "animation" for static sprite (optional)
@@ -31,6 +31,7 @@ Geezer::Geezer(
     idealInner(80.0f),
     minAttackRange(64.0f),
     projectileSpeed(300.0f),
+    wallAvoidRange(24.0f), // 1.5 tiles
     shotVariance(0.045f), // Approx +/- 2.6 degrees std dev
     posVariance(0.35f),   // Approx +/- 20 degrees std dev
     gen(rd()) {
@@ -100,6 +101,7 @@ void Geezer::control(Tilemap* map, float time, float deltaTime) {
     // Move towards destination if in a moving state
     if (currentState != GeezerState::G_IDLE && currentState != GeezerState::G_ATTACK) {
         moveToDestination(); // Sets vx, vy
+        avoidWalls(map);
     }
 
     // Fire projectile based on state and timing
@@ -141,6 +143,9 @@ void Geezer::fireAtTarget(float time) {
     // --- Fire the projectile ---
     if (!target) return; // Should not happen if state logic is correct, but safety check
 
+    // Don't waste shots into walls
+    if (!hasLineOfSight()) return;
+
     SDL_Point tgtPos = target->getPosition();
     float targetX = static_cast<float>(tgtPos.x);
     float targetY = static_cast<float>(tgtPos.y);
@@ -202,6 +207,29 @@ void Geezer::moveToDestination() {
     }
 }
 
+void Geezer::avoidWalls(const Tilemap* map) {
+    if (!map || (vx == 0.0f && vy == 0.0f)) return;
+
+    // Push away from walls harder the closer they are, so the Geezer slides
+    // along them instead of grinding into them
+    const DistanceField& walls = map->getDistanceField(mask);
+    float wallDist = walls.distance(x, y);
+    if (wallDist >= wallAvoidRange) return;
+    float awayX, awayY;
+    if (!walls.gradient(x, y, awayX, awayY)) return;
+
+    float push = (1.0f - wallDist / wallAvoidRange) * movementSpeed;
+    vx += awayX * push;
+    vy += awayY * push;
+
+    // Never faster than normal
+    float speed = std::sqrt(vx * vx + vy * vy);
+    if (speed > movementSpeed) {
+        vx *= movementSpeed / speed;
+        vy *= movementSpeed / speed;
+    }
+}
+
 float Geezer::distanceToTarget() const {
     if (!target) return std::numeric_limits<float>::max();
 
@@ -211,6 +239,20 @@ float Geezer::distanceToTarget() const {
     return std::sqrt(dx * dx + dy * dy);
 }
 
+bool Geezer::hasLineOfSight() {
+    if (!target) return false;
+
+    VisibilityService& visibility = entityManager->getVisibility();
+    // The player's visible set is precomputed every frame; anything else
+    // goes through the cached tile-pair query
+    if (dynamic_cast<Player*>(target)) {
+        return visibility.targetVisibleFrom(x, y);
+    }
+    return visibility.canSee(
+        x, y, target->x, target->y, CollisionLayer::MASK_ENEMY_PROJECTILE
+    );
+}
+
 void Geezer::setDestination(float time) {
     if (currentState == GeezerState::G_IDLE || currentState == GeezerState::G_ATTACK) {
         destinationX = x; // Stay put
@@ -55,6 +55,7 @@ private:
     float minAttackRange;   // Inner range for fleeing
 
     float projectileSpeed; // Speed of fireballs
+    float wallAvoidRange;  // Starts steering away from walls this close
 
     // Randomness for AI behavior
     std::random_device rd;
@@ -65,6 +66,8 @@ private:
     // AI Helper methods
     void fireAtTarget(float time);
     float distanceToTarget() const;
+    bool hasLineOfSight(); // Can fireballs reach the target from here?
     void setDestination(float time); // Calculate a new movement destination
     void moveToDestination();        // Set vx, vy towards current destination
+    void avoidWalls(const Tilemap* map); // Bend vx, vy away from nearby walls
 };
@@ -67,8 +67,10 @@ void Player::control(Tilemap* map, float time, float deltaTime) {
         }
     }
 
-    // Check for attack input
-    if (input_handler->is_mouse_button_pressed(SDL_BUTTON_LEFT)) {
+    // Check for attack input. A quick click can be down and up again before
+    // this tick runs, so the press edge counts as well as holding.
+    if (input_handler->is_mouse_button_pressed(SDL_BUTTON_LEFT) ||
+        input_handler->mouse_pressed_this_tick(SDL_BUTTON_LEFT)) {
         attack(time); // Call base class attack method
     }
 }
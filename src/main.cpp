@@ -4,16 +4,26 @@
 #include <sstream>
 #include <algorithm>
 #include <limits>
-#include <map> // Include map for tile layers
+#include <memory>
+#include <filesystem>
+#include <cstdlib> // For std::atoi
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 
 #include "utils/spritesheet.h"
+#include "utils/texture_atlas.h"
 #include "utils/audio.h"
+#include "utils/sound_bank.h"
 #include "utils/tilemap.h"
+#include "utils/layered_map.h"
+#include "utils/tileset.h"
+#include "utils/tile_animator.h"
 #include "utils/input.h"
+#include "utils/asset_loader.h"
+#include "utils/glyph_atlas.h"
+#include "utils/frame_pacer.h"
 #include "utils/collisions_defs.h" // Include collision definitions
 
 #include "game/player.h"
@@ -22,25 +32,16 @@
 
 enum class GameState { MAIN_MENU, PLAYING, PAUSED, GAME_OVER, QUIT };
 
-// Helper function to render text
-SDL_Texture* renderText(
-    SDL_Renderer* renderer, TTF_Font* font, const std::string& text,
-    SDL_Color color
-) {
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (!surface) {
-        std::cerr << "Failed to render text surface: " << TTF_GetError()
-                  << std::endl;
-        return nullptr;
-    }
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        std::cerr << "Failed to create texture from rendered text: "
-                  << SDL_GetError() << std::endl;
-    }
-    SDL_FreeSurface(surface);
-    return texture;
+// Progress bar shown while assets load (fonts may not be in yet)
+void drawLoadingScreen(SDL_Renderer* renderer, float progress) {
+    SDL_SetRenderDrawColor(renderer, 50, 20, 10, 255);
+    SDL_RenderClear(renderer);
+    SDL_Rect frame = {170, 230, 300, 20};
+    SDL_Rect fill = {frame.x + 2, frame.y + 2, static_cast<int>((frame.w - 4) * progress), frame.h - 4};
+    SDL_SetRenderDrawColor(renderer, 150, 150, 150, 255);
+    SDL_RenderDrawRect(renderer, &frame);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderFillRect(renderer, &fill);
 }
 
 // Function to set up entities for a new game/restart
@@ -88,6 +89,29 @@ void setupNewGame(EntityManager& entityManager, SDL_Renderer* renderer, InputHan
 
 
 int main(int argc, char* argv[]) {
+    // --- Command Line ---
+    // --pacing vsync|uncapped|capped|adaptive, --fps N (capped/adaptive
+    // target, default the display's refresh rate), --frame-stats FILE to
+    // write the frame-time histogram there at exit
+    PacingMode pacingMode = PacingMode::VSYNC;
+    int targetFps = 0;
+    std::string frameStatsPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--pacing" && i + 1 < argc) {
+            if (!parsePacingMode(argv[++i], pacingMode)) {
+                std::cerr << "Warning: Unknown pacing mode " << argv[i] << ", using vsync" << std::endl;
+                pacingMode = PacingMode::VSYNC;
+            }
+        } else if (arg == "--fps" && i + 1 < argc) {
+            targetFps = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--frame-stats" && i + 1 < argc) {
+            frameStatsPath = argv[++i];
+        } else {
+            std::cerr << "Warning: Ignoring argument " << arg << std::endl;
+        }
+    }
+
     // --- SDL Initialization ---
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         std::cerr << "SDL could not initialize: " << SDL_GetError() << std::endl;
@@ -121,47 +145,173 @@ int main(int argc, char* argv[]) {
     );
     if (!window) { /* ... error handling ... */ return 1; }
     SDL_Renderer* renderer = SDL_CreateRenderer(
-        window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+        window, -1, FramePacer::rendererFlags(pacingMode)
     );
     if (!renderer) { /* ... error handling ... */ return 1; }
+    FramePacer pacer(window, renderer, pacingMode, targetFps);
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Default background
 
-    // --- Fonts ---
-    TTF_Font* menuFont = TTF_OpenFont("assets/fonts/press_start/prstart.ttf", 28);
-    TTF_Font* hudFont = TTF_OpenFont("assets/fonts/press_start/prstart.ttf", 14);
-    if (!menuFont || !hudFont) { /* ... error handling ... */ return 1; }
+    // --- Asset Loading ---
+    // The window is up; fonts, music, the level and the sprite atlas load in
+    // the background while a progress bar shows. Workers read and decode,
+    // this thread only uploads and opens what was read.
+    std::vector<uint8_t> fontData, menuMusicData, levelMusicData; // Must outlive what's opened from them
+    TTF_Font* menuFont = nullptr;
+    TTF_Font* hudFont = nullptr;
+    std::unique_ptr<GlyphAtlas> menuGlyphs, hudGlyphs;
+    std::unique_ptr<SoundBank> soundBank;
+    std::unique_ptr<MusicTrack> menu_music, level_music;
+    std::unique_ptr<Tileset> dungeonTiles;
+    TextMap surfaceTiles, trapdoorTiles;
+    TextureAtlas::Packed packedAtlas;
+    std::unique_ptr<TextureAtlas> atlas;
+    std::unique_ptr<Spritesheet> sheet;
+    std::unique_ptr<TileAnimator> tileAnimator;
+    std::unique_ptr<LayeredMap> level;
+    const int atlasPageSize = TextureAtlas::maxPageSize(renderer);
+    AssetLoader loader; // Declared last so its workers stop before the above go away
+
+    loader.add(
+        [&] { fontData = readFileBytes("assets/fonts/press_start/prstart.ttf"); },
+        [&] {
+            // Both sizes read the same bytes
+            menuFont = TTF_OpenFontRW(SDL_RWFromConstMem(fontData.data(), static_cast<int>(fontData.size())), 1, 28);
+            hudFont = TTF_OpenFontRW(SDL_RWFromConstMem(fontData.data(), static_cast<int>(fontData.size())), 1, 14);
+            if (!menuFont || !hudFont) {
+                throw std::runtime_error(std::string("Failed to open font: ") + TTF_GetError());
+            }
+            // Every string on screen is drawn out of these
+            menuGlyphs = std::make_unique<GlyphAtlas>(renderer, menuFont);
+            hudGlyphs = std::make_unique<GlyphAtlas>(renderer, hudFont);
+        }
+    );
+    loader.add(
+        [&] {
+            // The packed bank (the build's sound_bank target) when it's there:
+            // mapping it costs nothing up front. Otherwise the loose files.
+            const char* bankPath = "assets/audio/game.sbk";
+            if (std::filesystem::exists(bankPath)) {
+                soundBank = std::make_unique<SoundBank>(bankPath);
+            } else {
+                menuMusicData = readFileBytes("assets/audio/patient_rituals.mp3");
+                levelMusicData = readFileBytes("assets/audio/level_theme.mp3");
+            }
+        },
+        [&] {
+            if (soundBank) {
+                menu_music = soundBank->openMusic("menu");
+                level_music = soundBank->openMusic("level");
+                if (!menu_music || !level_music) {
+                    throw std::runtime_error("Sound bank has no \"menu\" or \"level\" music");
+                }
+            } else {
+                menu_music = std::make_unique<MusicTrack>(menuMusicData.data(), menuMusicData.size());
+                level_music = std::make_unique<MusicTrack>(levelMusicData.data(), levelMusicData.size());
+            }
+        }
+    );
+    // --- Tilemap Setup ---
+    loader.add(
+        [&] {
+            // Tile collision layers come from the "collision" property on each
+            // tile in the tileset, so level designers can edit them in Tiled
+            dungeonTiles = std::make_unique<Tileset>("assets/tilesets/dungeon.tsx");
+            // Map dimensions come from the files themselves, padded with empty
+            // tiles to cover the whole 640x480 play area (40x30 tiles): off the
+            // map is LEVEL_BOUNDARY, and the spawns and fireballs need room
+            const int PLAY_WIDTH_TILES = 640 / 16;
+            const int PLAY_HEIGHT_TILES = 480 / 16;
+            surfaceTiles = loadTextMap("assets/maps/test_map_surfaces.txt");
+            trapdoorTiles = loadTextMap("assets/maps/test_map_trapdoors.txt");
+            padTextMap(surfaceTiles, PLAY_WIDTH_TILES, PLAY_HEIGHT_TILES);
+            padTextMap(trapdoorTiles, PLAY_WIDTH_TILES, PLAY_HEIGHT_TILES);
+            // Sprites and tiles share atlas pages so a frame draws from one or
+            // two textures; packed once, then loaded from the cache
+            packedAtlas = TextureAtlas::pack({
+                "assets/sprites/arcanist.png",
+                "assets/sprites/geezer.png",
+                "assets/sprites/fireball.png",
+                dungeonTiles->getImagePath(),
+            }, "cache/atlas", atlasPageSize);
+        },
+        [&] {
+            atlas = std::make_unique<TextureAtlas>(renderer, std::move(packedAtlas));
+            Spritesheet::useAtlas(atlas.get());
+            sheet = std::make_unique<Spritesheet>(renderer, dungeonTiles->getImagePath().c_str(), dungeonTiles->getTileWidth(), dungeonTiles->getTileHeight());
+            // Animated tiles (water, lava, ...) all run off this one clock
+            tileAnimator = std::make_unique<TileAnimator>(*dungeonTiles);
+
+            // Build the level from its layers using the tileset's collision table
+            level = std::make_unique<LayeredMap>(16, 16, surfaceTiles.width, surfaceTiles.height, dungeonTiles->getCollisionLut());
+            level->addLayer("surfaces", sheet.get(), surfaceTiles, false); // Visuals only
+            level->addLayer("trapdoors", nullptr, trapdoorTiles, true); // Collision only
+            level->setAnimator(tileAnimator.get());
+        }
+    );
+
+    // --- Loading Screen ---
+    // Uploads get a few milliseconds a frame so the bar keeps moving
+    const uint32_t LOAD_BUDGET_MS = 4;
+    bool gameRunning = true;
+    while (gameRunning && !loader.isDone()) {
+        SDL_Event loadEvent;
+        while (SDL_PollEvent(&loadEvent)) {
+            if (loadEvent.type == SDL_QUIT ||
+                (loadEvent.type == SDL_KEYDOWN && loadEvent.key.keysym.sym == SDLK_ESCAPE)) {
+                gameRunning = false;
+            }
+        }
+        loader.update(LOAD_BUDGET_MS);
+        drawLoadingScreen(renderer, loader.getProgress());
+        SDL_RenderPresent(renderer);
+    }
+    if (!gameRunning || loader.getFailureCount() > 0) {
+        if (gameRunning) std::cerr << "Couldn't load the game's assets." << std::endl;
+        loader.cancel(); // Workers may still be writing into what's freed below
+        level.reset();
+        sheet.reset();
+        Spritesheet::useAtlas(nullptr); // Sheets made later mustn't look in a freed atlas
+        atlas.reset();
+        menuGlyphs.reset();
+        hudGlyphs.reset();
+        menu_music.reset();
+        level_music.reset();
+        soundBank.reset();
+        if (menuFont) TTF_CloseFont(menuFont);
+        if (hudFont) TTF_CloseFont(hudFont);
+        AudioSystem::quit();
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        TTF_Quit();
+        IMG_Quit();
+        SDL_Quit();
+        return gameRunning ? 1 : 0;
+    }
 
     // --- Menu Resources ---
     SDL_Color white = {255, 255, 255, 255};
     SDL_Color gray = {150, 150, 150, 255};
     SDL_Color red = {255, 0, 0, 255};
+    // Labels tint one glyph atlas, so hover states need no extra textures
     // Main Menu
-    SDL_Texture* startTexture = renderText(renderer, menuFont, "Start Game", white);
-    SDL_Texture* desktopTexture = renderText(renderer, menuFont, "Quit to Desktop", white);
-    SDL_Texture* startTextureHover = renderText(renderer, menuFont, "Start Game", gray);
-    SDL_Texture* desktopTextureHover = renderText(renderer, menuFont, "Quit to Desktop", gray);
-    int startW, startH, desktopW, desktopH;
-    SDL_QueryTexture(startTexture, NULL, NULL, &startW, &startH);
-    SDL_QueryTexture(desktopTexture, NULL, NULL, &desktopW, &desktopH);
+    TextLabel startLabel(menuGlyphs.get(), "Start Game");
+    TextLabel desktopLabel(menuGlyphs.get(), "Quit to Desktop");
+    int startW = startLabel.getWidth(), startH = startLabel.getHeight();
+    int desktopW = desktopLabel.getWidth(), desktopH = desktopLabel.getHeight();
     SDL_Rect startButtonRect = {320 - startW / 2, 200, startW, startH};
     SDL_Rect desktopButtonRect = {320 - desktopW / 2, 260, desktopW, desktopH};
     // Pause Menu
-    SDL_Texture* continueTexture = renderText(renderer, menuFont, "Continue", white);
-    SDL_Texture* menuTexture = renderText(renderer, menuFont, "Quit to Menu", white);
-    SDL_Texture* continueTextureHover = renderText(renderer, menuFont, "Continue", gray);
-    SDL_Texture* menuTextureHover = renderText(renderer, menuFont, "Quit to Menu", gray);
-    int continueW, continueH, menuW, menuH;
-    SDL_QueryTexture(continueTexture, NULL, NULL, &continueW, &continueH);
-    SDL_QueryTexture(menuTexture, NULL, NULL, &menuW, &menuH);
+    TextLabel continueLabel(menuGlyphs.get(), "Continue");
+    TextLabel menuLabel(menuGlyphs.get(), "Quit to Menu");
+    int continueW = continueLabel.getWidth(), continueH = continueLabel.getHeight();
+    int menuW = menuLabel.getWidth(), menuH = menuLabel.getHeight();
     SDL_Rect continueButtonRect = {320 - continueW / 2, 140, continueW, continueH};
     SDL_Rect menuButtonRect = {320 - menuW / 2, 200, menuW, menuH};
     // Game Over Menu
-    SDL_Texture* gameOverTexture = renderText(renderer, menuFont, "GAME OVER", red);
-    SDL_Texture* restartTexture = renderText(renderer, menuFont, "Restart", white);
-    SDL_Texture* restartTextureHover = renderText(renderer, menuFont, "Restart", gray);
-    int gameOverW, gameOverH, restartW, restartH;
-    SDL_QueryTexture(gameOverTexture, NULL, NULL, &gameOverW, &gameOverH);
-    SDL_QueryTexture(restartTexture, NULL, NULL, &restartW, &restartH);
+    TextLabel gameOverLabel(menuGlyphs.get(), "GAME OVER");
+    TextLabel restartLabel(menuGlyphs.get(), "Restart");
+    int gameOverW = gameOverLabel.getWidth(), gameOverH = gameOverLabel.getHeight();
+    int restartW = restartLabel.getWidth(), restartH = restartLabel.getHeight();
     SDL_Rect gameOverRect = {320 - gameOverW / 2, 80, gameOverW, gameOverH};
     SDL_Rect restartButtonRect = {320 - restartW / 2, 140, restartW, restartH};
     // Shared button rects for pause/game over
@@ -175,40 +325,21 @@ int main(int argc, char* argv[]) {
     EntityManager entityManager(renderer);
     entityManager.setScreenDimensions(640, 480);
     InputHandler handler;
-    MusicTrack menu_music("assets/audio/patient_rituals.mp3");
-    MusicTrack level_music("assets/audio/level_theme.mp3");
-
-    // --- Tilemap Setup ---
-    Spritesheet sheet(renderer, "assets/tilesets/Dungeon_16x16_asset_pack/tileset.png", 16, 16);
-    // Define which tile indices map to which collision layers
-    std::map<int, CollisionLayer> collisionMap;
-    // Example: Indices 0-8, 12-14, 26 are walls/obstacles/boundaries
-    int wall_indices[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 13, 14, 26};
-    for (int index : wall_indices) {
-        // Assign a combined layer for simplicity, or be more specific
-        collisionMap[index] = CollisionLayer::LEVEL_WALL | CollisionLayer::LEVEL_OBSTACLE | CollisionLayer::LEVEL_BOUNDARY;
-    }
-    // Add other layers (pits, hazards) if needed: collisionMap[PIT_INDEX] = CollisionLayer::LEVEL_PIT;
-
-    // Create tilemaps using the collision map
-    // Assuming map dimensions are known or loaded from file meta-data
-    // For now, hardcoding dimensions based on file names (e.g., 40x30 tiles = 640x480)
-    const int MAP_WIDTH_TILES = 40;
-    const int MAP_HEIGHT_TILES = 30;
-    Tilemap surface_map(&sheet, 16, 16, MAP_WIDTH_TILES, MAP_HEIGHT_TILES, collisionMap, "assets/maps/test_map_surfaces.txt");
-    Tilemap collision_layer_map(&sheet, 16, 16, MAP_WIDTH_TILES, MAP_HEIGHT_TILES, collisionMap, "assets/maps/test_map_trapdoors.txt"); // Use this map for collision checks
 
 
     // --- Game Loop Variables ---
     GameState currentState = GameState::MAIN_MENU;
-    bool gameRunning = true;
     SDL_Event event;
     Uint32 lastTick = SDL_GetTicks(); // Use Uint32 for ticks
     int mouseX = 0, mouseY = 0;
     bool mousePressed = false;
+    // HUD
+    TextLabel healthLabel(hudGlyphs.get());
+    int shownHealth = -1, shownMaxHealth = -1; // Values healthLabel shows
 
-    menu_music.play(-1);
-    menu_music.setVolume(10); // Low volume for menu
+    menu_music->setVolume(10); // Low volume for menu
+    level_music->setVolume(50);
+    MusicManager::play(menu_music.get());
 
     // --- Main Game Loop ---
     while (gameRunning) {
@@ -220,54 +351,50 @@ int main(int argc, char* argv[]) {
         if (deltaTime > 0.1f) deltaTime = 0.1f;
         lastTick = currentTick;
         float time = currentTick / 1000.0f; // Total time in seconds
+        tileAnimator->update(currentTick);
+        VoiceManager::update(); // Sounds triggered from here on belong to this frame
+        MusicManager::update();
 
         // --- Event Handling ---
-        mousePressed = false; // Reset mouse press state each frame
         while (SDL_PollEvent(&event)) {
+            handler.handle_event(event); // Queued with its timestamp for begin_tick
             switch (event.type) {
             case SDL_QUIT:
                 gameRunning = false;
                 break;
+            case SDL_RENDER_TARGETS_RESET:
+            case SDL_RENDER_DEVICE_RESET:
+                // Cached map chunks were lost with the render targets
+                level->invalidateRenderCache();
+                break;
             case SDL_KEYDOWN:
                 if (!event.key.repeat) {
-                    handler.handle_keydown(event.key.keysym.sym);
                     // Pause/Resume Toggle
                     if (event.key.keysym.sym == SDLK_ESCAPE) {
                         if (currentState == GameState::PLAYING) {
                             currentState = GameState::PAUSED;
-                            level_music.setVolume(10); // Lower volume when paused
+                            level_music->setVolume(10); // Lower volume when paused
                         } else if (currentState == GameState::PAUSED) {
                             currentState = GameState::PLAYING;
-                            level_music.setVolume(50); // Restore volume
+                            level_music->setVolume(50); // Restore volume
                         } else if (currentState == GameState::MAIN_MENU || currentState == GameState::GAME_OVER) {
                              gameRunning = false; // Esc quits from main/game over
                         }
                     }
                 }
                 break;
-            case SDL_KEYUP:
-                handler.handle_keyup(event.key.keysym.sym);
-                break;
             case SDL_MOUSEMOTION:
-                handler.handle_mousemotion(event.motion.x, event.motion.y);
                 mouseX = event.motion.x;
                 mouseY = event.motion.y;
                 break;
-            case SDL_MOUSEBUTTONDOWN:
-                handler.handle_mousebuttondown(
-                    event.button.button, event.button.x, event.button.y
-                );
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    mousePressed = true;
-                }
-                break;
-            case SDL_MOUSEBUTTONUP:
-                handler.handle_mousebuttonup(
-                    event.button.button, event.button.x, event.button.y
-                );
-                break;
             }
         }
+        // Everything that happened up to now belongs to this frame's tick.
+        // The game steps once per frame; a fixed-step loop would call this
+        // once per step with that step's end time.
+        handler.begin_tick(SDL_GetTicks());
+        // A click is a press edge, so one that's released before the frame runs still counts
+        mousePressed = handler.mouse_pressed_this_tick(SDL_BUTTON_LEFT);
 
         // --- Update Game State ---
         SDL_Point mousePoint = {mouseX, mouseY};
@@ -281,9 +408,8 @@ int main(int argc, char* argv[]) {
                 if (onStart) {
                     currentState = GameState::PLAYING;
                     setupNewGame(entityManager, renderer, handler); // Setup entities
-                    menu_music.pause();
-                    level_music.play(-1);
-                    level_music.setVolume(50);
+                    level_music->setVolume(50); // Could still be ducked from a pause
+                    MusicManager::play(level_music.get());
                     mousePressed = false; // Consume click
                 } else if (onDesktop) {
                     gameRunning = false;
@@ -292,20 +418,23 @@ int main(int argc, char* argv[]) {
             // Render Menu
             SDL_SetRenderDrawColor(renderer, 50, 20, 10, 255); // Background
             SDL_RenderClear(renderer);
-            SDL_RenderCopy(renderer, onStart ? startTextureHover : startTexture, NULL, &startButtonRect);
-            SDL_RenderCopy(renderer, onDesktop ? desktopTextureHover : desktopTexture, NULL, &desktopButtonRect);
+            startLabel.draw(renderer, startButtonRect.x, startButtonRect.y, onStart ? gray : white);
+            desktopLabel.draw(renderer, desktopButtonRect.x, desktopButtonRect.y, onDesktop ? gray : white);
 
         } break;
 
         case GameState::PLAYING: {
+            // Let caches built on the maps catch up with last frame's tile edits
+            level->flushChanges();
+
             // Update Entities & Collisions
-            entityManager.update(&collision_layer_map, time, deltaTime); // Pass the collision map
+            entityManager.update(level->getCollisionMap(), time, deltaTime); // Pass the merged collision map
 
             // Check for Game Over condition
             Player* player = entityManager.getPlayer();
             if (!player || !player->isAlive()) {
                 currentState = GameState::GAME_OVER;
-                level_music.stop();
+                MusicManager::stop();
                 // Optionally play game over sound
                 break; // Skip rendering this frame if game just ended
             }
@@ -313,22 +442,21 @@ int main(int argc, char* argv[]) {
             // Render Game World
             SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black background
             SDL_RenderClear(renderer);
-            surface_map.draw(renderer, 0, 0); // Draw visual map
-            // collision_layer_map.draw(renderer, 0, 0); // Optionally draw collision map for debug
+            level->draw(renderer, 0.0f, 0.0f); // Draw every visible layer
             entityManager.render();
 
             // Render HUD
-            std::stringstream healthText;
-            healthText << "Health: " << static_cast<int>(player->getHealth())
-                       << " / " << static_cast<int>(player->getMaxHealth());
-            SDL_Texture* healthTexture = renderText(renderer, hudFont, healthText.str(), white);
-            if (healthTexture) {
-                int healthW, healthH;
-                SDL_QueryTexture(healthTexture, NULL, NULL, &healthW, &healthH);
-                SDL_Rect healthRect = {10, 10, healthW, healthH};
-                SDL_RenderCopy(renderer, healthTexture, NULL, &healthRect);
-                SDL_DestroyTexture(healthTexture); // Clean up texture
+            // The label is only rebuilt when the numbers it shows change
+            int health = static_cast<int>(player->getHealth());
+            int maxHealth = static_cast<int>(player->getMaxHealth());
+            if (health != shownHealth || maxHealth != shownMaxHealth) {
+                shownHealth = health;
+                shownMaxHealth = maxHealth;
+                std::stringstream healthText;
+                healthText << "Health: " << health << " / " << maxHealth;
+                healthLabel.setText(healthText.str());
             }
+            healthLabel.draw(renderer, 10, 10, white);
 
         } break;
 
@@ -340,13 +468,12 @@ int main(int argc, char* argv[]) {
              if (mousePressed) {
                  if (onContinue) {
                      currentState = GameState::PLAYING;
-                     level_music.setVolume(50); // Restore volume
+                     level_music->setVolume(50); // Restore volume
                      mousePressed = false;
                  } else if (onMenu) {
                      currentState = GameState::MAIN_MENU;
                      entityManager.clearAll(); // Clear entities when going to menu
-                     level_music.stop();
-                     menu_music.play(-1);
+                     MusicManager::play(menu_music.get());
                      mousePressed = false;
                  } else if (onDesktop) {
                      gameRunning = false;
@@ -356,7 +483,7 @@ int main(int argc, char* argv[]) {
              // Render Paused State (Game world dimmed)
              SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
              SDL_RenderClear(renderer);
-             surface_map.draw(renderer, 0, 0);
+             level->draw(renderer, 0.0f, 0.0f);
              entityManager.render(); // Render entities in their paused state
 
              // Dimming Overlay
@@ -367,9 +494,9 @@ int main(int argc, char* argv[]) {
              SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE); // Reset blend mode
 
              // Render Pause Menu Buttons
-             SDL_RenderCopy(renderer, onContinue ? continueTextureHover : continueTexture, NULL, &continueButtonRect);
-             SDL_RenderCopy(renderer, onMenu ? menuTextureHover : menuTexture, NULL, &pauseMenuButtonRect);
-             SDL_RenderCopy(renderer, onDesktop ? desktopTextureHover : desktopTexture, NULL, &pauseDesktopButtonRect);
+             continueLabel.draw(renderer, continueButtonRect.x, continueButtonRect.y, onContinue ? gray : white);
+             menuLabel.draw(renderer, pauseMenuButtonRect.x, pauseMenuButtonRect.y, onMenu ? gray : white);
+             desktopLabel.draw(renderer, pauseDesktopButtonRect.x, pauseDesktopButtonRect.y, onDesktop ? gray : white);
 
         } break;
 
@@ -382,13 +509,13 @@ int main(int argc, char* argv[]) {
                  if (onRestart) {
                      currentState = GameState::PLAYING;
                      setupNewGame(entityManager, renderer, handler); // Restart game
-                     level_music.play(-1);
-                     level_music.setVolume(50);
+                     level_music->setVolume(50); // Could still be ducked from a pause
+                    MusicManager::play(level_music.get());
                      mousePressed = false;
                  } else if (onMenu) {
                      currentState = GameState::MAIN_MENU;
                      entityManager.clearAll();
-                     menu_music.play(-1);
+                     MusicManager::play(menu_music.get());
                      mousePressed = false;
                  } else if (onDesktop) {
                      gameRunning = false;
@@ -398,7 +525,7 @@ int main(int argc, char* argv[]) {
              // Render Game Over State (Game world dimmed red)
              SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
              SDL_RenderClear(renderer);
-             surface_map.draw(renderer, 0, 0);
+             level->draw(renderer, 0.0f, 0.0f);
              entityManager.render(); // Render entities (e.g., dead player)
 
              // Dimming Overlay (Red tint)
@@ -409,10 +536,10 @@ int main(int argc, char* argv[]) {
              SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 
              // Render Game Over Text & Buttons
-             SDL_RenderCopy(renderer, gameOverTexture, NULL, &gameOverRect);
-             SDL_RenderCopy(renderer, onRestart ? restartTextureHover : restartTexture, NULL, &restartButtonRect);
-             SDL_RenderCopy(renderer, onMenu ? menuTextureHover : menuTexture, NULL, &gameOverMenuButtonRect);
-             SDL_RenderCopy(renderer, onDesktop ? desktopTextureHover : desktopTexture, NULL, &gameOverDesktopButtonRect);
+             gameOverLabel.draw(renderer, gameOverRect.x, gameOverRect.y, red);
+             restartLabel.draw(renderer, restartButtonRect.x, restartButtonRect.y, onRestart ? gray : white);
+             menuLabel.draw(renderer, gameOverMenuButtonRect.x, gameOverMenuButtonRect.y, onMenu ? gray : white);
+             desktopLabel.draw(renderer, gameOverDesktopButtonRect.x, gameOverDesktopButtonRect.y, onDesktop ? gray : white);
 
         } break;
 
@@ -428,23 +555,34 @@ int main(int argc, char* argv[]) {
         // Done once per frame, after updates and rendering potentially
         entityManager.cleanupEntities();
 
+        // --- Pace ---
+        // Last thing in the frame: waits out a capped frame and records its time
+        pacer.endFrame();
+
     } // End Main Game Loop
 
+    // --- Frame Stats ---
+    // Always collected; only reported when asked for
+    if (!frameStatsPath.empty()) {
+        std::cout << pacer.summary() << std::endl;
+        if (!pacer.writeReport(frameStatsPath.c_str())) {
+            std::cerr << "Warning: Couldn't write frame stats to " << frameStatsPath << std::endl;
+        }
+    }
+
     // --- Cleanup ---
     entityManager.clearAll(); // Ensure all entities are cleared
 
-    // Destroy Textures
-    SDL_DestroyTexture(startTexture);
-    SDL_DestroyTexture(desktopTexture);
-    SDL_DestroyTexture(startTextureHover);
-    SDL_DestroyTexture(desktopTextureHover);
-    SDL_DestroyTexture(continueTexture);
-    SDL_DestroyTexture(menuTexture);
-    SDL_DestroyTexture(continueTextureHover);
-    SDL_DestroyTexture(menuTextureHover);
-    SDL_DestroyTexture(gameOverTexture);
-    SDL_DestroyTexture(restartTexture);
-    SDL_DestroyTexture(restartTextureHover);
+    // Level, atlas and glyph textures go before the renderer, music before audio
+    level.reset();
+    sheet.reset();
+    Spritesheet::useAtlas(nullptr); // Sheets made later mustn't look in a freed atlas
+    atlas.reset();
+    menuGlyphs.reset();
+    hudGlyphs.reset();
+    menu_music.reset();
+    level_music.reset();
+    soundBank.reset(); // After everything playing out of it
 
     // Close Fonts
     TTF_CloseFont(menuFont);
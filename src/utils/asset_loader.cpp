@@ -0,0 +1,118 @@
+#include "asset_loader.h"
+#include <algorithm> // For std::max
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+AssetLoader::AssetLoader(int workerCount) {
+    if (workerCount <= 0) {
+        workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
+}
+
+AssetLoader::~AssetLoader() {
+    cancel();
+}
+
+void AssetLoader::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        pending.clear();
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    finished.clear(); // Their finish halves must not run any more
+    completed = queued;
+}
+
+void AssetLoader::add(std::function<void()> work, std::function<void()> finish) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return; // Cancelled: no workers left to run it
+        pending.push_back({std::move(work), std::move(finish), std::string()});
+    }
+    // A fresh batch: progress counts from zero again
+    if (completed == queued) {
+        completed = queued = 0;
+    }
+    ++queued;
+    wake.notify_one();
+}
+
+void AssetLoader::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping) return;
+            job = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        try {
+            if (job.work) job.work();
+        } catch (const std::exception& e) {
+            job.error = e.what();
+        } catch (...) {
+            job.error = "unknown error";
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(std::move(job));
+    }
+}
+
+void AssetLoader::update(uint32_t budgetMs) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(budgetMs);
+    do {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished.empty()) return;
+            job = std::move(finished.front());
+            finished.pop_front();
+        }
+
+        if (job.error.empty() && job.finish) {
+            try {
+                job.finish();
+            } catch (const std::exception& e) {
+                job.error = e.what();
+            } catch (...) {
+                job.error = "unknown error";
+            }
+        }
+        if (!job.error.empty()) {
+            std::cerr << "Asset failed to load: " << job.error << std::endl;
+            ++failures;
+        }
+        ++completed;
+    } while (Clock::now() < deadline);
+}
+
+float AssetLoader::getProgress() const {
+    return queued == 0 ? 1.0f : static_cast<float>(completed) / queued;
+}
+
+std::vector<uint8_t> readFileBytes(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Couldn't open " + path);
+    }
+    std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Couldn't read " + path);
+    }
+    return bytes;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loads assets in the background so the window comes up at once and level
+// changes don't freeze it. Each job has two halves:
+//   work   - runs on a worker thread: reading files, decoding images,
+//            parsing maps. Must not touch the renderer.
+//   finish - runs later on the main thread inside update(): texture
+//            uploads and anything else SDL wants on the render thread.
+// update() only spends its time budget on finish halves, so a loading
+// screen keeps animating while a big batch comes in.
+//
+//   loader.add([&] { fontData = readFileBytes(path); },
+//              [&] { font = TTF_OpenFontRW(SDL_RWFromConstMem(...), 1, 14); });
+//   while (!loader.isDone()) { loader.update(4); drawProgress(loader.getProgress()); }
+//
+// A job whose work throws is reported (std::cerr) and its finish skipped;
+// a finish that throws is reported the same way. Either counts as a failure.
+class AssetLoader {
+public:
+    // 0 workers picks one fewer than the hardware threads (at least one)
+    explicit AssetLoader(int workerCount = 0);
+    // Drops queued work and waits for running jobs
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    void add(std::function<void()> work, std::function<void()> finish = nullptr);
+
+    // Drops queued and finished jobs and waits for running ones, so nothing
+    // their work halves write to is touched afterwards. Call before freeing
+    // what the jobs load into (e.g. quitting mid-load). The loader takes no
+    // more jobs after this; the destructor does the same.
+    void cancel();
+
+    // Runs finished jobs' main-thread halves until `budgetMs` has been
+    // spent; at least one runs per call so loading always moves forward
+    void update(uint32_t budgetMs);
+
+    // Fraction of the jobs added since the loader was last idle that are
+    // completely done, 0..1
+    float getProgress() const;
+    bool isDone() const { return completed == queued; }
+    int getFailureCount() const { return failures; }
+
+private:
+    struct Job {
+        std::function<void()> work;
+        std::function<void()> finish;
+        std::string error; // Set if work threw
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> pending;  // Waiting for a worker
+    std::deque<Job> finished; // Waiting for update()
+    bool stopping = false;
+
+    // Main thread only
+    int queued = 0;
+    int completed = 0;
+    int failures = 0;
+
+    void workerLoop();
+};
+
+// A whole file in memory, for assets that are then opened from memory on
+// the main thread (fonts, music). Throws std::runtime_error.
+std::vector<uint8_t> readFileBytes(const std::string& path);
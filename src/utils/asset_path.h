@@ -0,0 +1,22 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// Paths inside asset files (tileset sources in maps, images in tilesets)
+// are relative to the file that names them, unless they're absolute.
+
+// Directory part of `path` with its trailing separator, "" for a bare name
+inline std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? std::string() : path.substr(0, slash + 1);
+}
+
+// `source` as named by a file in `directory` (from directoryOf): relative
+// paths are joined on, absolute ones are used as they are
+inline std::string resolveAssetPath(const std::string& directory, std::string_view source) {
+    if (std::filesystem::path(source).is_absolute()) {
+        return std::string(source);
+    }
+    return directory + std::string(source);
+}
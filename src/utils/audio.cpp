@@ -1,4 +1,31 @@
 #include "audio.h"
+#include <algorithm> // For std::min, std::max
+#include <cmath>     // For std::sqrt, std::lround
+#include <unordered_map>
+#include <utility>   // For std::move
+
+namespace {
+// Decoded chunks by path. Weak, so a chunk is freed with its last SoundEffect.
+std::unordered_map<std::string, std::weak_ptr<Mix_Chunk>> loaded_chunks;
+
+// Mixer channels; also the hard cap on sound effects playing at once
+constexpr int VOICE_COUNT = 32;
+}
+
+const MusicTrack* MusicManager::current = nullptr;
+MusicTrack* MusicManager::next = nullptr;
+int MusicManager::nextLoops = -1;
+bool MusicManager::switching = false;
+int MusicManager::fadeMs = MusicManager::DEFAULT_FADE_MS;
+
+std::vector<VoiceManager::Voice> VoiceManager::voices;
+uint64_t VoiceManager::playCount = 0;
+uint32_t VoiceManager::frame = 0;
+float VoiceManager::listenerX = 0.0f;
+float VoiceManager::listenerY = 0.0f;
+float VoiceManager::hearingRange = VoiceManager::DEFAULT_HEARING_RANGE;
+float VoiceManager::panWidth = VoiceManager::DEFAULT_PAN_WIDTH;
+int VoiceManager::spatialCursor = 0;
 
 bool AudioSystem::init(int frequency, Uint16 format, int channels, int chunksize) {
     if (SDL_Init(SDL_INIT_AUDIO) < 0) {
@@ -12,38 +39,214 @@ bool AudioSystem::init(int frequency, Uint16 format, int channels, int chunksize
         return false;
     }
 
-    Mix_AllocateChannels(32); // 32 channels is arbitrary, adjust as needed
+    VoiceManager::allocate(VOICE_COUNT);
     
     return true;
 }
 
 void AudioSystem::quit() {
+    VoiceManager::stopAll();
     Mix_CloseAudio();
     SDL_QuitSubSystem(SDL_INIT_AUDIO);
 }
 
-// load sound effect file from path
-SoundEffect::SoundEffect(const char * path) {
-    chunk_ = Mix_LoadWAV(path);
+// load sound effect file from path, or share it if it's already loaded
+SoundEffect::SoundEffect(const char * path, int priority, int maxVoices) :
+    priority_(priority),
+    maxVoices_(maxVoices)
+{
+    std::weak_ptr<Mix_Chunk>& cached = loaded_chunks[path];
+    chunk_ = cached.lock();
     if (!chunk_) {
-        throw std::runtime_error(std::string("Failed to load sound effect: ") + Mix_GetError());
+        Mix_Chunk* chunk = Mix_LoadWAV(path);
+        if (!chunk) {
+            throw std::runtime_error(std::string("Failed to load sound effect: ") + Mix_GetError());
+        }
+        chunk_ = std::shared_ptr<Mix_Chunk>(chunk, Mix_FreeChunk);
+        cached = chunk_;
     }
 }
 
-SoundEffect::~SoundEffect() {
-    if (chunk_) {
-        Mix_FreeChunk(chunk_);
+SoundEffect::SoundEffect(std::shared_ptr<Mix_Chunk> chunk, int priority, int maxVoices) :
+    chunk_(std::move(chunk)),
+    priority_(priority),
+    maxVoices_(maxVoices)
+{}
+
+void SoundEffect::play(int loops) const {
+    VoiceManager::play(chunk_.get(), priority_, maxVoices_, volume_, loops);
+}
+
+int SoundEffect::playAt(float x, float y, int loops) const {
+    return VoiceManager::playAt(chunk_.get(), priority_, maxVoices_, volume_, loops, x, y);
+}
+
+int SoundEffect::playFrom(const SoundSource& source, int loops) const {
+    return VoiceManager::playAt(
+        chunk_.get(), priority_, maxVoices_, volume_, loops, source.getX(), source.getY(), &source
+    );
+}
+
+void SoundEffect::setVolume(int volume) {
+    volume_ = volume;
+}
+
+SoundSource::~SoundSource() {
+    VoiceManager::detach(this);
+}
+
+void VoiceManager::allocate(int count) {
+    Mix_AllocateChannels(count);
+    voices.assign(count, Voice());
+}
+
+int VoiceManager::play(Mix_Chunk* chunk, int priority, int maxVoices, int volume, int loops) {
+    Voice placed;
+    placed.chunk = chunk;
+    placed.priority = priority;
+    return start(placed, maxVoices, volume, loops);
+}
+
+int VoiceManager::playAt(
+    Mix_Chunk* chunk, int priority, int maxVoices, int volume, int loops,
+    float x, float y, const SoundSource* source
+) {
+    Voice placed;
+    placed.chunk = chunk;
+    placed.priority = priority;
+    placed.positional = true;
+    placed.source = source;
+    placed.x = x;
+    placed.y = y;
+    if (!spatialize(x, y, placed.angle, placed.distance)) {
+        return -1; // Too far to hear; don't spend a voice on it
     }
+    return start(placed, maxVoices, volume, loops);
 }
 
-void SoundEffect::play(int loops) const {
-    if (Mix_PlayChannel(-1, chunk_, loops) == -1) {
+int VoiceManager::start(Voice placed, int maxVoices, int volume, int loops) {
+    int freeVoice = -1;
+    int sameCount = 0;
+    int oldestSame = -1;
+    int victim = -1;
+    for (int i = 0; i < static_cast<int>(voices.size()); ++i) {
+        const Voice& voice = voices[i];
+        if (!Mix_Playing(i)) {
+            if (freeVoice < 0) freeVoice = i;
+            continue;
+        }
+        if (voice.chunk == placed.chunk) {
+            // Already started this frame: one trigger is as loud as ten
+            if (voice.frame == frame) return i;
+            ++sameCount;
+            if (oldestSame < 0 || voice.started < voices[oldestSame].started) oldestSame = i;
+        }
+        if (victim < 0 || voice.priority < voices[victim].priority ||
+            (voice.priority == voices[victim].priority && voice.started < voices[victim].started)) {
+            victim = i;
+        }
+    }
+
+    int channel;
+    if (maxVoices > 0 && sameCount >= maxVoices) {
+        channel = oldestSame;
+    } else if (freeVoice >= 0) {
+        channel = freeVoice;
+    } else if (victim >= 0 && voices[victim].priority <= placed.priority) {
+        channel = victim;
+    } else {
+        return -1; // Everything playing matters more
+    }
+
+    if (Mix_Playing(channel)) {
+        Mix_HaltChannel(channel);
+    }
+    Mix_Volume(channel, volume);
+    if (placed.positional) {
+        // Placed before it starts, so the first samples are already panned
+        Mix_SetPosition(channel, placed.angle, placed.distance);
+    } else if (voices[channel].positional) {
+        Mix_SetPosition(channel, 0, 0); // Unregisters the position effect
+    }
+    if (Mix_PlayChannel(channel, placed.chunk, loops) == -1) {
         SDL_Log("Failed to play sound effect: %s", Mix_GetError());
+        return -1;
     }
+    placed.started = ++playCount;
+    placed.frame = frame;
+    voices[channel] = placed;
+    return channel;
 }
 
-void SoundEffect::setVolume(int volume) {
-    Mix_VolumeChunk(chunk_, volume);
+void VoiceManager::update() {
+    ++frame;
+    updateSpatial();
+}
+
+void VoiceManager::updateSpatial() {
+    const int count = static_cast<int>(voices.size());
+    int applied = 0;
+    int nextCursor = spatialCursor;
+    for (int n = 0; n < count; ++n) {
+        int i = (spatialCursor + n) % count;
+        Voice& voice = voices[i];
+        if (!voice.positional || !Mix_Playing(i)) continue;
+        if (voice.source) {
+            voice.x = voice.source->getX();
+            voice.y = voice.source->getY();
+        }
+        Sint16 angle;
+        Uint8 distance;
+        spatialize(voice.x, voice.y, angle, distance); // Out of range comes back silent
+        if (angle == voice.angle && distance == voice.distance) continue;
+        if (applied == MAX_SPATIAL_UPDATES) continue; // Positions still tracked; sent on its turn
+        Mix_SetPosition(i, angle, distance);
+        voice.angle = angle;
+        voice.distance = distance;
+        ++applied;
+        nextCursor = (i + 1) % count;
+    }
+    spatialCursor = nextCursor;
+}
+
+bool VoiceManager::spatialize(float x, float y, Sint16& angle, Uint8& distance) {
+    float dx = x - listenerX;
+    float dy = y - listenerY;
+    float length = std::sqrt(dx * dx + dy * dy);
+    float pan = std::max(-1.0f, std::min(1.0f, dx / panWidth));
+    long degrees = std::lround(pan * 90.0f);
+    angle = static_cast<Sint16>(degrees < 0 ? degrees + 360 : degrees);
+    if (length >= hearingRange) {
+        distance = 255;
+        return false;
+    }
+    distance = static_cast<Uint8>(std::lround(length / hearingRange * 255.0f));
+    return true;
+}
+
+void VoiceManager::detach(const SoundSource* source) {
+    for (Voice& voice : voices) {
+        if (voice.source == source) {
+            voice.source = nullptr; // Stays where the source was last seen
+        }
+    }
+}
+
+void VoiceManager::stopAll() {
+    if (!voices.empty()) {
+        Mix_HaltChannel(-1);
+    }
+    for (Voice& voice : voices) {
+        voice = Voice();
+    }
+}
+
+int VoiceManager::getActiveVoiceCount() {
+    int active = 0;
+    for (int i = 0; i < static_cast<int>(voices.size()); ++i) {
+        if (Mix_Playing(i)) ++active;
+    }
+    return active;
 }
 
 MusicTrack::MusicTrack(const char * path) {
@@ -53,20 +256,34 @@ MusicTrack::MusicTrack(const char * path) {
     }
 }
 
+MusicTrack::MusicTrack(const void * data, size_t size) {
+    music_ = Mix_LoadMUS_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1);
+    if (!music_) {
+        throw std::runtime_error(std::string("Failed to load music track: ") + Mix_GetError());
+    }
+}
+
 MusicTrack::~MusicTrack() {
+    MusicManager::forget(this);
     if (music_) {
         Mix_FreeMusic(music_);
     }
 }
 
 void MusicTrack::play(int loops) const {
+    MusicManager::current = this;
+    MusicManager::switching = false;
+    Mix_VolumeMusic(volume_);
     if (Mix_PlayMusic(music_, loops) == -1) {
         SDL_Log("Failed to play music: %s", Mix_GetError());
     }
 }
 
 void MusicTrack::setVolume(int volume) {
-    Mix_VolumeMusic(volume);
+    volume_ = volume;
+    if (MusicManager::current == this) {
+        Mix_VolumeMusic(volume);
+    }
 }
 
 void MusicTrack::pause() {
@@ -79,4 +296,67 @@ void MusicTrack::resume() {
 
 void MusicTrack::stop() {
     Mix_HaltMusic();
+}
+
+void MusicManager::play(MusicTrack* track, int loops) {
+    if (Mix_PausedMusic() && (current || switching)) {
+        // Paused music still counts as playing, so a fade-out would never
+        // finish. It's silent anyway: resume the same track, or cut to the
+        // new one straight away.
+        if (!switching && track == current) {
+            Mix_ResumeMusic();
+            return;
+        }
+        Mix_HaltMusic();
+        switching = false;
+        next = nullptr;
+        start(track, loops);
+        return;
+    }
+    if (!switching && track == current && (!track || Mix_PlayingMusic())) {
+        return; // Already playing it
+    }
+    if (switching || (current && Mix_PlayingMusic())) {
+        // Fade out first; update() starts the track once that's done
+        if (!switching) {
+            Mix_FadeOutMusic(fadeMs / 2);
+            switching = true;
+        }
+        next = track;
+        nextLoops = loops;
+        return;
+    }
+    start(track, loops);
+}
+
+void MusicManager::stop() {
+    play(nullptr);
+}
+
+void MusicManager::update() {
+    // Fade-outs finish on the audio thread; pick up the next track from here
+    // rather than from Mix_HookMusicFinished, which can't call back into the mixer
+    if (switching && Mix_PausedMusic()) {
+        Mix_HaltMusic(); // Paused mid-fade: the fade would never end
+    }
+    if (switching && !Mix_PlayingMusic()) {
+        switching = false;
+        start(next, nextLoops);
+        next = nullptr;
+    }
+}
+
+void MusicManager::start(MusicTrack* track, int loops) {
+    current = track;
+    if (!track) return;
+    Mix_VolumeMusic(track->volume_);
+    if (Mix_FadeInMusic(track->music_, loops, fadeMs / 2) == -1) {
+        SDL_Log("Failed to play music: %s", Mix_GetError());
+        current = nullptr;
+    }
+}
+
+void MusicManager::forget(const MusicTrack* track) {
+    if (current == track) current = nullptr;
+    if (next == track) next = nullptr;
 }
\ No newline at end of file
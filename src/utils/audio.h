@@ -1,7 +1,11 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 class AudioClip {
 public:
@@ -10,31 +14,208 @@ public:
     virtual void setVolume(int volume) = 0;
 };
 
+class SoundSource;
+
+// A decoded sample. Every SoundEffect made from the same path shares one
+// decoded chunk, so spawning a hundred fireballs decodes their sound once.
+// Playing goes through the VoiceManager: `priority` decides which sounds win
+// when every voice is busy, `maxVoices` caps how many copies of this sound
+// can play at once.
 class SoundEffect : public AudioClip {
 public:
-    SoundEffect(const char * path);
-    ~SoundEffect();
+    SoundEffect(const char * path, int priority = 0, int maxVoices = 4);
+    // Shares an already decoded chunk (e.g. one out of a SoundBank)
+    SoundEffect(std::shared_ptr<Mix_Chunk> chunk, int priority = 0, int maxVoices = 4);
 
+    // Plays everywhere at once (UI, music stingers). May be dropped if
+    // every voice is busy with higher-priority sounds.
     void play(int loops = 0) const override;
+    // Plays from a world position, panned and attenuated relative to the
+    // listener. Returns the channel, or -1 if it was too far away to start
+    // or lost to higher-priority sounds.
+    int playAt(float x, float y, int loops = 0) const;
+    // Like playAt, but the voice keeps following the source as it moves
+    int playFrom(const SoundSource& source, int loops = 0) const;
+    // Volume of this SoundEffect's voices only; others sharing the chunk keep theirs
     void setVolume(int volume) override;
+    void setPriority(int priority) { priority_ = priority; }
+    void setMaxVoices(int maxVoices) { maxVoices_ = maxVoices; }
+
+    int getPriority() const { return priority_; }
+    int getMaxVoices() const { return maxVoices_; }
 
 private:
-    Mix_Chunk* chunk_;
+    std::shared_ptr<Mix_Chunk> chunk_;
+    int volume_ = MIX_MAX_VOLUME;
+    int priority_;
+    int maxVoices_;
 };
 
+// A music stream. Its decoder is opened here, so keep tracks that are
+// coming up loaded (the asset loader opens them all at startup) and
+// switching to one is instant. Switch through MusicManager to fade.
 class MusicTrack : public AudioClip {
 public:
     MusicTrack(const char * path);
+    // Streams from an encoded file already in memory; the data must outlive the track
+    MusicTrack(const void * data, size_t size);
     ~MusicTrack();
 
+    // Starts at once, cutting off whatever was playing
     void play(int loops = -1) const override;
+    // This track's own volume; heard whenever it's the one playing
     void setVolume(int volume) override;
+    int getVolume() const { return volume_; }
     static void pause();
     static void resume();
     static void stop();
 
 private:
+    friend class MusicManager;
+
     Mix_Music* music_;
+    int volume_ = MIX_MAX_VOLUME;
+};
+
+// Switches music without cutting it: the old track fades out, then the new
+// one fades in, each over half the fade time. SDL_mixer only has one music
+// stream, so the two can't overlap; decoding still happens on the audio
+// thread and every call here returns at once, so state changes never stall
+// a frame.
+class MusicManager {
+public:
+    static constexpr int DEFAULT_FADE_MS = 1000;
+
+    // Fades over to `track`; nothing happens if it's already playing
+    static void play(MusicTrack* track, int loops = -1);
+    // Fades out to silence
+    static void stop();
+    // Call once per frame; starts the next track once the old one has faded
+    static void update();
+
+    static void setFadeTime(int ms) { fadeMs = ms; }
+    static int getFadeTime() { return fadeMs; }
+    // The track playing or fading in, null if none
+    static const MusicTrack* getCurrent() { return current; }
+
+    MusicManager() = delete;
+
+private:
+    friend class MusicTrack;
+
+    static const MusicTrack* current;
+    static MusicTrack* next;  // Starts when `current` has faded out
+    static int nextLoops;
+    static bool switching;    // Fading out towards `next` (which may be null)
+    static int fadeMs;
+
+    static void start(MusicTrack* track, int loops);
+    // A track going away mustn't be left as current or next
+    static void forget(const MusicTrack* track);
+};
+
+// A point sounds can be attached to, usually owned by an entity that moves
+// it every frame. Voices playing from it follow it; when it's destroyed
+// they stay where it last was.
+class SoundSource {
+public:
+    SoundSource() = default;
+    ~SoundSource();
+
+    // Voices hold on to the source by address
+    SoundSource(const SoundSource&) = delete;
+    SoundSource& operator=(const SoundSource&) = delete;
+
+    void setPosition(float newX, float newY) { x = newX; y = newY; }
+    float getX() const { return x; }
+    float getY() const { return y; }
+
+private:
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Hands out the mixer's channels ("voices") to sound effects. Rules, in order:
+//  - the same sound triggered again in the same frame is collapsed into the
+//    voice already started (a volley of fireballs is one sound, not ten)
+//  - a sound at its maxVoices restarts its own oldest voice
+//  - otherwise a free voice is used
+//  - otherwise the lowest-priority voice is stolen (oldest among equals),
+//    but never one with higher priority than the new sound, which is
+//    dropped instead
+// The voice count is fixed at AudioSystem::init, so mixing cost stays
+// bounded however busy the game gets.
+//
+// Positional voices further than the hearing range from the listener are
+// never started. Their pan and distance are worked out for all of them
+// together in update(), but only MAX_SPATIAL_UPDATES that actually changed
+// are sent to the mixer per frame (taking turns), since each one locks the
+// audio thread.
+class VoiceManager {
+public:
+    static constexpr int MAX_SPATIAL_UPDATES = 8;
+    static constexpr float DEFAULT_HEARING_RANGE = 480.0f;
+    static constexpr float DEFAULT_PAN_WIDTH = 320.0f;
+
+    // Returns the channel used, or -1 if the sound was dropped
+    static int play(Mix_Chunk* chunk, int priority, int maxVoices, int volume, int loops = 0);
+    // Positional; `source` (optional) is followed while the voice plays
+    static int playAt(
+        Mix_Chunk* chunk, int priority, int maxVoices, int volume, int loops,
+        float x, float y, const SoundSource* source = nullptr
+    );
+    // Call once per frame; starts a new same-frame collapse window and
+    // moves positional voices to where the listener and sources are now
+    static void update();
+    static void stopAll();
+
+    // Where the player hears from (world pixels)
+    static void setListener(float x, float y) { listenerX = x; listenerY = y; }
+    // Sounds this far away are silent and don't start
+    static void setHearingRange(float range) { hearingRange = range; }
+    // Sounds this far to one side are fully in that ear
+    static void setPanWidth(float width) { panWidth = width; }
+
+    static int getVoiceCount() { return static_cast<int>(voices.size()); }
+    static int getActiveVoiceCount();
+
+    VoiceManager() = delete;
+
+private:
+    friend class AudioSystem;
+
+    friend class SoundSource;
+
+    struct Voice {
+        Mix_Chunk* chunk = nullptr;
+        int priority = 0;
+        uint64_t started = 0;   // play() order, for finding the oldest
+        uint32_t frame = 0;     // update() count when it started
+        // Positional voices only
+        bool positional = false;
+        const SoundSource* source = nullptr;
+        float x = 0.0f;
+        float y = 0.0f;
+        Sint16 angle = 0;       // Last sent to the mixer
+        Uint8 distance = 0;
+    };
+
+    static std::vector<Voice> voices; // Indexed by mixer channel
+    static uint64_t playCount;
+    static uint32_t frame;
+    static float listenerX, listenerY;
+    static float hearingRange;
+    static float panWidth;
+    static int spatialCursor; // Voice whose turn it is to be updated first
+
+    static void allocate(int count);
+    // Finds `placed` a channel by the rules above and starts it there
+    static int start(Voice placed, int maxVoices, int volume, int loops);
+    static void updateSpatial();
+    // Mixer angle (0 ahead, 90 right, 270 left) and distance (255 silent)
+    // for a sound at x, y; false if it's out of hearing range
+    static bool spatialize(float x, float y, Sint16& angle, Uint8& distance);
+    static void detach(const SoundSource* source);
 };
 
 class AudioSystem {
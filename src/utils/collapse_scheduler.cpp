@@ -0,0 +1,68 @@
+#include "collapse_scheduler.h"
+#include <algorithm> // For std::min, std::remove_if
+#include <cmath>     // For std::floor
+#include <stdexcept>
+
+CollapseScheduler::CollapseScheduler(Tilemap* map) : map(map) {
+    if (!map) {
+        throw std::runtime_error("CollapseScheduler created with null tilemap.");
+    }
+}
+
+void CollapseScheduler::schedule(
+    const TileRect& region, int tile_index, float delay, float interval, Sweep sweep
+) {
+    if (region.w <= 0 || region.h <= 0) return;
+    jobs.push_back({region, tile_index, std::max(0.0f, delay), std::max(0.0f, interval), sweep, 0});
+}
+
+void CollapseScheduler::update(float deltaTime) {
+    for (Job& job : jobs) {
+        bool horizontal = job.sweep == Sweep::LEFT_TO_RIGHT || job.sweep == Sweep::RIGHT_TO_LEFT;
+        int lines = horizontal ? job.region.w : job.region.h;
+
+        job.timer -= deltaTime;
+        if (job.timer > 0.0f) continue;
+
+        // Catch up on every line that came due this frame, in one edit
+        int due = lines - job.done;
+        if (job.interval > 0.0f) {
+            due = std::min(due, 1 + static_cast<int>(std::floor(-job.timer / job.interval)));
+            job.timer += due * job.interval;
+        }
+        collapseLines(job, job.done, due);
+        job.done += due;
+    }
+
+    jobs.erase(
+        std::remove_if(jobs.begin(), jobs.end(), [](const Job& job) {
+            bool horizontal = job.sweep == Sweep::LEFT_TO_RIGHT || job.sweep == Sweep::RIGHT_TO_LEFT;
+            return job.done >= (horizontal ? job.region.w : job.region.h);
+        }),
+        jobs.end()
+    );
+}
+
+void CollapseScheduler::collapseLines(const Job& job, int first, int count) {
+    if (count <= 0) return;
+    TileRect lines = job.region;
+    switch (job.sweep) {
+    case Sweep::LEFT_TO_RIGHT:
+        lines.x += first;
+        lines.w = count;
+        break;
+    case Sweep::RIGHT_TO_LEFT:
+        lines.x += job.region.w - first - count;
+        lines.w = count;
+        break;
+    case Sweep::TOP_TO_BOTTOM:
+        lines.y += first;
+        lines.h = count;
+        break;
+    case Sweep::BOTTOM_TO_TOP:
+        lines.y += job.region.h - first - count;
+        lines.h = count;
+        break;
+    }
+    map->setTiles(lines, job.tile_index);
+}
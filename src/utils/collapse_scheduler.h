@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include "tilemap.h"
+
+// Collapses regions of a Tilemap over time, e.g. the floor crumbling away
+// behind the player. Each job replaces its region one line of tiles at a
+// time through Tilemap::setTiles, so a step costs one line, not the map.
+class CollapseScheduler {
+public:
+    // Which edge of the region goes first
+    enum class Sweep {
+        LEFT_TO_RIGHT,
+        RIGHT_TO_LEFT,
+        TOP_TO_BOTTOM,
+        BOTTOM_TO_TOP
+    };
+
+    explicit CollapseScheduler(Tilemap* map);
+
+    // After `delay` seconds, replaces `region` with `tile_index` (-1 to
+    // clear it), one column or row every `interval` seconds. An interval of
+    // 0 collapses the whole region at once.
+    void schedule(
+        const TileRect& region, int tile_index, float delay, float interval,
+        Sweep sweep = Sweep::LEFT_TO_RIGHT
+    );
+
+    // Advances every job; call once per frame
+    void update(float deltaTime);
+
+    void clear() { jobs.clear(); }
+    bool isIdle() const { return jobs.empty(); }
+
+private:
+    struct Job {
+        TileRect region;
+        int tile_index;
+        float timer;    // Seconds until the next line collapses
+        float interval;
+        Sweep sweep;
+        int done;       // Lines collapsed so far
+    };
+
+    Tilemap* map;
+    std::vector<Job> jobs;
+
+    // Collapses lines [first, first + count) of a job
+    void collapseLines(const Job& job, int first, int count);
+};
@@ -0,0 +1,166 @@
+#include "distance_field.h"
+#include <algorithm> // For std::max, std::min
+#include <cmath>     // For std::floor, std::sqrt
+#include "tilemap.h"
+
+namespace {
+// The 3-4 chamfer overestimates Euclidean distance by at most this factor
+// (worst at a 1:3 slope), so dividing by it gives a lower bound
+constexpr float CHAMFER_OVERESTIMATE = 1.0541f;
+}
+
+DistanceField::DistanceField(const Tilemap& map, CollisionLayer mask) :
+    map(&map),
+    mask(mask),
+    width(map.getMapWidth()),
+    height(map.getMapHeight())
+{
+    rebuild();
+}
+
+void DistanceField::rebuild() {
+    cells.assign(static_cast<size_t>(width) * height, FAR);
+    // A border of MAX_TILES lets the map edge act as a wall if it is one
+    compute(
+        -MAX_TILES, -MAX_TILES, width + MAX_TILES, height + MAX_TILES,
+        0, 0, width, height
+    );
+}
+
+void DistanceField::update(int x0, int y0, int x1, int y1) {
+    // Tiles further than MAX_TILES from the change keep their distance. For
+    // those that might not, any blocker closer than MAX_TILES (and the
+    // chamfer path to it, which stays inside the pair's bounding box) lies
+    // within another MAX_TILES, so that's all the transform needs to see.
+    int ux0 = std::max(x0 - MAX_TILES, 0);
+    int uy0 = std::max(y0 - MAX_TILES, 0);
+    int ux1 = std::min(x1 + MAX_TILES, width);
+    int uy1 = std::min(y1 + MAX_TILES, height);
+    if (ux0 >= ux1 || uy0 >= uy1) return;
+    compute(
+        ux0 - MAX_TILES, uy0 - MAX_TILES, ux1 + MAX_TILES, uy1 + MAX_TILES,
+        ux0, uy0, ux1, uy1
+    );
+}
+
+void DistanceField::compute(
+    int wx0, int wy0, int wx1, int wy1, int ux0, int uy0, int ux1, int uy1
+) {
+    const int w = wx1 - wx0;
+    const int h = wy1 - wy0;
+    const int originX = map->getOriginX();
+    const bool boundaryBlocks = ::checkCollision(mask, CollisionLayer::LEVEL_BOUNDARY);
+
+    std::vector<uint8_t> window(static_cast<size_t>(w) * h);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int localX = wx0 + x;
+            int localY = wy0 + y;
+            bool blocks;
+            if (localX < 0 || localX >= width || localY < 0 || localY >= height) {
+                blocks = boundaryBlocks;
+            } else {
+                blocks = ::checkCollision(mask, map->getTileLayer(localX + originX, localY));
+            }
+            window[y * w + x] = blocks ? 0 : FAR;
+        }
+    }
+
+    // Forward pass: top-left neighbours
+    for (int y = 0; y < h; ++y) {
+        uint8_t* row = window.data() + y * w;
+        const uint8_t* above = y > 0 ? row - w : nullptr;
+        for (int x = 0; x < w; ++x) {
+            int d = row[x];
+            if (d == 0) continue;
+            if (x > 0) d = std::min(d, row[x - 1] + STRAIGHT);
+            if (above) {
+                d = std::min(d, above[x] + STRAIGHT);
+                if (x > 0) d = std::min(d, above[x - 1] + DIAGONAL);
+                if (x + 1 < w) d = std::min(d, above[x + 1] + DIAGONAL);
+            }
+            row[x] = static_cast<uint8_t>(d);
+        }
+    }
+    // Backward pass: bottom-right neighbours
+    for (int y = h - 1; y >= 0; --y) {
+        uint8_t* row = window.data() + y * w;
+        const uint8_t* below = y + 1 < h ? row + w : nullptr;
+        for (int x = w - 1; x >= 0; --x) {
+            int d = row[x];
+            if (d == 0) continue;
+            if (x + 1 < w) d = std::min(d, row[x + 1] + STRAIGHT);
+            if (below) {
+                d = std::min(d, below[x] + STRAIGHT);
+                if (x + 1 < w) d = std::min(d, below[x + 1] + DIAGONAL);
+                if (x > 0) d = std::min(d, below[x - 1] + DIAGONAL);
+            }
+            row[x] = static_cast<uint8_t>(d);
+        }
+    }
+
+    for (int y = uy0; y < uy1; ++y) {
+        const uint8_t* source = window.data() + (y - wy0) * w + (ux0 - wx0);
+        std::copy(source, source + (ux1 - ux0), cells.begin() + y * width + ux0);
+    }
+}
+
+int DistanceField::cellAt(int localX, int localY) const {
+    if (localX < 0 || localX >= width || localY < 0 || localY >= height) {
+        return ::checkCollision(mask, CollisionLayer::LEVEL_BOUNDARY) ? 0 : FAR;
+    }
+    return cells[localY * width + localX];
+}
+
+float DistanceField::distance(float x, float y) const {
+    // Cell-centre coordinates: (0, 0) is the centre of the window's first tile
+    float fx = x / map->getTileWidth() - map->getOriginX() - 0.5f;
+    float fy = y / map->getTileHeight() - 0.5f;
+    int ix = static_cast<int>(std::floor(fx));
+    int iy = static_cast<int>(std::floor(fy));
+    float tx = fx - ix;
+    float ty = fy - iy;
+
+    float top = cellAt(ix, iy) + (cellAt(ix + 1, iy) - cellAt(ix, iy)) * tx;
+    float bottom = cellAt(ix, iy + 1) + (cellAt(ix + 1, iy + 1) - cellAt(ix, iy + 1)) * tx;
+    float tiles = (top + (bottom - top) * ty) / STRAIGHT;
+    return tiles * std::min(map->getTileWidth(), map->getTileHeight());
+}
+
+bool DistanceField::gradient(float x, float y, float& gx, float& gy) const {
+    float fx = x / map->getTileWidth() - map->getOriginX() - 0.5f;
+    float fy = y / map->getTileHeight() - 0.5f;
+    int ix = static_cast<int>(std::floor(fx));
+    int iy = static_cast<int>(std::floor(fy));
+    float tx = fx - ix;
+    float ty = fy - iy;
+
+    // Derivatives of the same bilinear patch distance() samples
+    int d00 = cellAt(ix, iy), d10 = cellAt(ix + 1, iy);
+    int d01 = cellAt(ix, iy + 1), d11 = cellAt(ix + 1, iy + 1);
+    gx = (d10 - d00) + ((d11 - d01) - (d10 - d00)) * ty;
+    gy = (d01 - d00) + ((d11 - d10) - (d01 - d00)) * tx;
+
+    float length = std::sqrt(gx * gx + gy * gy);
+    if (length <= 0.0f) {
+        gx = gy = 0.0f;
+        return false;
+    }
+    gx /= length;
+    gy /= length;
+    return true;
+}
+
+float DistanceField::clearance(float x, float y) const {
+    const float tileW = static_cast<float>(map->getTileWidth());
+    const float tileH = static_cast<float>(map->getTileHeight());
+    int localX = static_cast<int>(std::floor(x / tileW)) - map->getOriginX();
+    int localY = static_cast<int>(std::floor(y / tileH));
+
+    // Centre-to-centre distance to the nearest blocker is at least the
+    // chamfer value over its worst-case error; every grid step is at least
+    // the smaller tile side. The point may sit anywhere in its tile and the
+    // blocker extends around its centre: half a diagonal each.
+    float centres = cellAt(localX, localY) / (STRAIGHT * CHAMFER_OVERESTIMATE) * std::min(tileW, tileH);
+    return std::max(0.0f, centres - std::sqrt(tileW * tileW + tileH * tileH));
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "collisions_defs.h"
+
+class Tilemap;
+
+// Distance from every tile to the nearest tile that blocks a collision mask,
+// so "how far is the nearest wall" is a lookup instead of a batch of
+// checkCollision or raycast calls. It's a 3-4 chamfer transform over the
+// tile grid (within ~6% of true distance), capped at MAX_TILES. The cap
+// keeps edits local: changing a tile can only affect distances within
+// MAX_TILES of it, so only that neighbourhood is recomputed.
+//
+// Fields are owned and kept up to date by their Tilemap; get one with
+// Tilemap::getDistanceField(mask). Positions are world coordinates.
+class DistanceField {
+public:
+    // Distances at or past this many tiles all read as "far"
+    static constexpr int MAX_TILES = 8;
+
+    DistanceField(const Tilemap& map, CollisionLayer mask);
+
+    CollisionLayer getMask() const { return mask; }
+
+    // Approximate distance in world units to the nearest blocking tile,
+    // interpolated between tile centres so it varies smoothly with position.
+    // Good for steering; use clearance() when it must not overestimate.
+    float distance(float x, float y) const;
+    // Direction in which distance() grows fastest, i.e. away from nearby
+    // walls, as a unit vector. Returns false (and zeros) where the field is
+    // flat, e.g. further than MAX_TILES from any wall.
+    bool gradient(float x, float y, float& gx, float& gy) const;
+    // Lower bound on the distance in world units from (x, y) to any blocking
+    // tile. Anything that moves less than this (plus its own extent) can't
+    // touch a blocking tile, so its collision tests can be skipped.
+    float clearance(float x, float y) const;
+
+    // Recomputes everything, e.g. after the map scrolled or its LUT changed
+    void rebuild();
+    // Recomputes what tiles [x0, x1) x [y0, y1) (window coordinates) can
+    // affect after they changed
+    void update(int x0, int y0, int x1, int y1);
+
+private:
+    // Chamfer steps, in thirds of a tile
+    static constexpr int STRAIGHT = 3;
+    static constexpr int DIAGONAL = 4;
+    static constexpr int FAR = MAX_TILES * STRAIGHT;
+
+    const Tilemap* map;
+    CollisionLayer mask;
+    int width;
+    int height;
+    std::vector<uint8_t> cells; // Chamfer distance per tile, 0..FAR
+
+    // Distance of a window cell; outside the map is 0 if the mask collides
+    // with LEVEL_BOUNDARY, otherwise FAR
+    int cellAt(int localX, int localY) const;
+    // Runs the transform over the window [wx0, wx1) x [wy0, wy1), which may
+    // extend past the map, and stores results for [ux0, ux1) x [uy0, uy1)
+    void compute(int wx0, int wy0, int wx1, int wy1, int ux0, int uy0, int ux1, int uy1);
+};
@@ -0,0 +1,199 @@
+#include "frame_pacer.h"
+#include <algorithm> // For std::min
+#include <cmath>     // For std::ceil
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+bool parsePacingMode(const std::string& name, PacingMode& mode) {
+    if (name == "vsync") mode = PacingMode::VSYNC;
+    else if (name == "uncapped") mode = PacingMode::UNCAPPED;
+    else if (name == "capped") mode = PacingMode::CAPPED;
+    else if (name == "adaptive") mode = PacingMode::ADAPTIVE;
+    else return false;
+    return true;
+}
+
+const char* pacingModeName(PacingMode mode) {
+    switch (mode) {
+    case PacingMode::VSYNC: return "vsync";
+    case PacingMode::UNCAPPED: return "uncapped";
+    case PacingMode::CAPPED: return "capped";
+    case PacingMode::ADAPTIVE: return "adaptive";
+    }
+    return "?";
+}
+
+void FrameTimeHistogram::record(double ms) {
+    int bucket = static_cast<int>(ms / BUCKET_MS);
+    counts[std::min(std::max(bucket, 0), BUCKETS)] += 1;
+    ++frames;
+    totalMs += ms;
+    if (ms > maxMs) maxMs = ms;
+}
+
+void FrameTimeHistogram::clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    frames = 0;
+    totalMs = 0.0;
+    maxMs = 0.0;
+}
+
+double FrameTimeHistogram::percentile(double percent) const {
+    if (frames == 0) return 0.0;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percent / 100.0 * frames));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return (i + 1) * BUCKET_MS; // Upper edge of the bucket
+    }
+    return maxMs; // In the overflow bucket
+}
+
+uint64_t FrameTimeHistogram::countOver(double ms) const {
+    // From the bucket holding ms: its frames may be up to a bucket short of
+    // ms, but leaving it out would miss frames just over the threshold
+    int first = static_cast<int>(ms / BUCKET_MS);
+    uint64_t over = 0;
+    for (int i = std::max(first, 0); i <= BUCKETS; ++i) {
+        over += counts[i];
+    }
+    return over;
+}
+
+void FrameTimeHistogram::write(std::ostream& out) const {
+    out << std::fixed << std::setprecision(1);
+    out << "frames " << frames << "\n"
+        << "mean_ms " << getMean() << "\n"
+        << "p50_ms " << percentile(50) << "\n"
+        << "p95_ms " << percentile(95) << "\n"
+        << "p99_ms " << percentile(99) << "\n"
+        << "max_ms " << maxMs << "\n"
+        << "# bucket_ms count (bucket = frames shorter than it, down to the previous one)\n";
+    for (int i = 0; i < BUCKETS; ++i) {
+        if (counts[i]) out << (i + 1) * BUCKET_MS << " " << counts[i] << "\n";
+    }
+    if (counts[BUCKETS]) out << "over " << counts[BUCKETS] << "\n";
+}
+
+FramePacer::FramePacer(SDL_Window* window, SDL_Renderer* renderer, PacingMode mode, int targetFps) :
+    renderer(renderer),
+    mode(mode),
+    ticksPerMs(SDL_GetPerformanceFrequency() / 1000.0)
+{
+    SDL_DisplayMode display;
+    int refreshRate = 60;
+    if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &display) == 0 && display.refresh_rate > 0) {
+        refreshRate = display.refresh_rate;
+    }
+    refreshMs = 1000.0 / refreshRate;
+    targetMs = targetFps > 0 ? 1000.0 / targetFps : refreshMs;
+
+    SDL_RendererInfo info;
+    vsyncOn = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+    setMode(mode);
+}
+
+Uint32 FramePacer::rendererFlags(PacingMode mode) {
+    Uint32 flags = SDL_RENDERER_ACCELERATED;
+    if (mode == PacingMode::VSYNC || mode == PacingMode::ADAPTIVE) {
+        flags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+    return flags;
+}
+
+void FramePacer::setMode(PacingMode newMode) {
+    mode = newMode;
+    setVsync(mode == PacingMode::VSYNC || mode == PacingMode::ADAPTIVE);
+    windowFrames = windowMisses = 0;
+    deadline = 0;
+}
+
+void FramePacer::setVsync(bool on) {
+    if (on == vsyncOn || vsyncLocked) return;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (SDL_RenderSetVSync(renderer, on ? 1 : 0) == 0) {
+        vsyncOn = on;
+        return;
+    }
+#endif
+    vsyncLocked = true; // Won't work any better next time; warn once
+    std::cerr << "Warning: Couldn't turn vsync " << (on ? "on" : "off")
+              << "; pacing stays as the renderer was created" << std::endl;
+}
+
+void FramePacer::endFrame() {
+    bool capped = mode == PacingMode::CAPPED || (mode == PacingMode::ADAPTIVE && !vsyncOn);
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (capped) {
+        limit(now);
+        now = SDL_GetPerformanceCounter();
+    }
+
+    if (lastFrame != 0) {
+        double frameMs = (now - lastFrame) / ticksPerMs;
+        histogram.record(frameMs);
+        if (mode == PacingMode::ADAPTIVE) adapt(frameMs);
+    }
+    lastFrame = now;
+}
+
+void FramePacer::limit(Uint64 now) {
+    const Uint64 period = static_cast<Uint64>(targetMs * ticksPerMs);
+    if (deadline == 0 || now > deadline + period) {
+        // First capped frame, or too far behind to catch up: start over from now
+        deadline = now + period;
+    }
+    const Uint64 spin = static_cast<Uint64>(SPIN_MS * ticksPerMs);
+    if (now + spin < deadline) {
+        SDL_Delay(static_cast<Uint32>((deadline - now - spin) / ticksPerMs));
+    }
+    while (SDL_GetPerformanceCounter() < deadline) {
+        // Spin out the last couple of milliseconds
+    }
+    deadline += period;
+}
+
+void FramePacer::adapt(double frameMs) {
+    ++windowFrames;
+    // With vsync a miss costs a whole refresh, so anything well past one counts
+    if (frameMs > refreshMs * 1.5) ++windowMisses;
+    if (windowFrames < ADAPTIVE_WINDOW) return;
+
+    if (vsyncOn && windowMisses >= ADAPTIVE_MISSES) {
+        setVsync(false); // Late frames tear instead of waiting a whole refresh
+        deadline = 0;
+    } else if (!vsyncOn && windowMisses == 0) {
+        setVsync(true);
+    }
+    windowFrames = windowMisses = 0;
+}
+
+std::string FramePacer::summary() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1)
+        << "Frames: " << histogram.getFrameCount()
+        << ", p50 " << histogram.percentile(50) << " ms"
+        << ", p95 " << histogram.percentile(95) << " ms"
+        << ", p99 " << histogram.percentile(99) << " ms"
+        << ", max " << histogram.getMax() << " ms"
+        << ", hitches (>2x " << targetMs << " ms) " << histogram.countOver(targetMs * 2);
+    return out.str();
+}
+
+bool FramePacer::writeReport(const char* path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << std::fixed << std::setprecision(1)
+        << "mode " << pacingModeName(mode) << "\n"
+        << "target_ms " << targetMs << "\n"
+        << "refresh_ms " << refreshMs << "\n"
+        << "# hitches count frames from the 0.1 ms bucket holding each threshold\n"
+        << "hitches_1.5x " << histogram.countOver(targetMs * 1.5) << "\n"
+        << "hitches_2x " << histogram.countOver(targetMs * 2) << "\n"
+        << "hitches_4x " << histogram.countOver(targetMs * 4) << "\n";
+    histogram.write(out);
+    return static_cast<bool>(out);
+}
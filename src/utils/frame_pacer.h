@@ -0,0 +1,111 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+enum class PacingMode {
+    VSYNC,    // Present waits for the display (the default)
+    UNCAPPED, // As fast as it goes
+    CAPPED,   // No vsync; a limiter holds a target FPS
+    ADAPTIVE, // Vsync while frames keep up; capped without it while they don't
+};
+
+// "vsync", "uncapped", "capped" or "adaptive"; false if it's none of them
+bool parsePacingMode(const std::string& name, PacingMode& mode);
+const char* pacingModeName(PacingMode mode);
+
+// Frame times in 0.1 ms buckets up to 100 ms (longer ones share the last
+// bucket but still count towards the max), cheap enough to leave on.
+class FrameTimeHistogram {
+public:
+    static constexpr double BUCKET_MS = 0.1;
+    static constexpr int BUCKETS = 1000;
+
+    FrameTimeHistogram() : counts(BUCKETS + 1, 0) {}
+
+    void record(double ms);
+    void clear();
+
+    uint64_t getFrameCount() const { return frames; }
+    // Frame time at or below which `percent` of frames fall, to the bucket
+    double percentile(double percent) const;
+    double getMax() const { return maxMs; }
+    double getMean() const { return frames ? totalMs / frames : 0.0; }
+    // Frames longer than `ms`, to the bucket: the whole bucket holding `ms`
+    // counts, so none over it are missed
+    uint64_t countOver(double ms) const;
+
+    // Summary followed by the non-empty buckets, as plain text
+    void write(std::ostream& out) const;
+
+private:
+    std::vector<uint64_t> counts;
+    uint64_t frames = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+};
+
+// Paces the main loop and measures it. Call endFrame() once at the end of
+// every frame, after SDL_RenderPresent:
+//   FramePacer pacer(window, renderer, PacingMode::CAPPED, 144);
+//   while (running) { ...; SDL_RenderPresent(renderer); pacer.endFrame(); }
+//
+// The capped limiter sleeps for most of the wait and spins on the
+// performance counter for the last SPIN_MS, since SDL_Delay can oversleep
+// by a scheduler tick. Deadlines advance by whole frame periods, so one
+// slow frame doesn't shift every later one.
+//
+// Renderers have to be created with vsync for VSYNC and ADAPTIVE (see
+// rendererFlags()); switching vsync at runtime needs SDL 2.0.18.
+class FramePacer {
+public:
+    static constexpr double SPIN_MS = 2.0;
+    // Frames missing the refresh interval this often (of ADAPTIVE_WINDOW)
+    // turn vsync off in ADAPTIVE mode; none missing turns it back on
+    static constexpr int ADAPTIVE_WINDOW = 60;
+    static constexpr int ADAPTIVE_MISSES = 6;
+
+    // targetFps 0 uses the display's refresh rate
+    FramePacer(SDL_Window* window, SDL_Renderer* renderer, PacingMode mode, int targetFps = 0);
+
+    // SDL_CreateRenderer flags to go with `mode`
+    static Uint32 rendererFlags(PacingMode mode);
+
+    void setMode(PacingMode newMode);
+    PacingMode getMode() const { return mode; }
+    double getTargetFrameMs() const { return targetMs; }
+
+    // Waits out the rest of the frame if capped, then records how long the
+    // frame took, present to present
+    void endFrame();
+
+    const FrameTimeHistogram& getHistogram() const { return histogram; }
+    // Pacing settings and the histogram; false if the file couldn't be written
+    bool writeReport(const char* path) const;
+    // p50/p95/p99/max and hitches on one line
+    std::string summary() const;
+
+private:
+    SDL_Renderer* renderer;
+    PacingMode mode;
+    double targetMs;
+    double refreshMs;
+    bool vsyncOn;
+    bool vsyncLocked = false; // Switching vsync failed; stay as we are
+
+    double ticksPerMs;
+    Uint64 lastFrame = 0;  // Counter at the last endFrame, 0 before the first
+    Uint64 deadline = 0;   // When the current capped frame should end
+
+    // ADAPTIVE: recent frames that missed the refresh interval
+    int windowFrames = 0;
+    int windowMisses = 0;
+
+    FrameTimeHistogram histogram;
+
+    void setVsync(bool on);
+    void limit(Uint64 now);
+    void adapt(double frameMs);
+};
@@ -0,0 +1,143 @@
+#include "glyph_atlas.h"
+#include <algorithm> // For std::max
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+// Glyphs are packed in rows across a texture this wide
+constexpr int ATLAS_WIDTH = 512;
+// Transparent pixels between glyphs so filtering never bleeds
+constexpr int PADDING = 1;
+}
+
+GlyphAtlas::GlyphAtlas(SDL_Renderer* renderer, TTF_Font* font) {
+    if (!font) {
+        throw std::runtime_error("GlyphAtlas needs a font");
+    }
+    lineHeight = TTF_FontLineSkip(font);
+
+    // Each glyph is rendered as a one-character string: that gives a cell as
+    // tall as the font with the glyph already on the baseline, the same
+    // placement TTF_RenderText uses for whole strings
+    const SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* cells[LAST_CHAR - FIRST_CHAR + 1] = {};
+    int x = 0, y = 0, rowHeight = 0;
+    for (char c = FIRST_CHAR; c <= LAST_CHAR; ++c) {
+        Glyph& glyph = glyphs[c - FIRST_CHAR];
+        int minX, maxX, minY, maxY;
+        if (TTF_GlyphMetrics(font, static_cast<Uint16>(c), &minX, &maxX, &minY, &maxY, &glyph.advance) != 0) {
+            continue; // Not in the font
+        }
+        const char text[2] = {c, '\0'};
+        SDL_Surface* cell = TTF_RenderText_Blended(font, text, white);
+        glyph.present = true;
+        if (!cell) {
+            continue; // Blank (some SDL_ttf versions won't render a lone space): advance only
+        }
+        if (x + cell->w > ATLAS_WIDTH) {
+            x = 0;
+            y += rowHeight + PADDING;
+            rowHeight = 0;
+        }
+        glyph.src = {x, y, cell->w, cell->h};
+        cells[c - FIRST_CHAR] = cell;
+        x += cell->w + PADDING;
+        rowHeight = std::max(rowHeight, cell->h);
+    }
+
+    SDL_Surface* page = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, std::max(1, y + rowHeight), 32, SDL_PIXELFORMAT_RGBA32);
+    if (page) {
+        for (int i = 0; i <= LAST_CHAR - FIRST_CHAR; ++i) {
+            if (!cells[i]) continue;
+            // Copy pixels as they are, alpha included
+            SDL_SetSurfaceBlendMode(cells[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dest = glyphs[i].src;
+            SDL_BlitSurface(cells[i], nullptr, page, &dest);
+        }
+        texture = SDL_CreateTextureFromSurface(renderer, page);
+        SDL_FreeSurface(page);
+    }
+    for (SDL_Surface* cell : cells) {
+        if (cell) SDL_FreeSurface(cell);
+    }
+    if (!texture) {
+        throw std::runtime_error(std::string("Failed to create glyph atlas: ") + SDL_GetError());
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    if (!glyphs['?' - FIRST_CHAR].present) {
+        std::cerr << "Warning: Font has no '?' glyph; unknown characters will be skipped" << std::endl;
+    }
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::glyphFor(char c) const {
+    if (c >= FIRST_CHAR && c <= LAST_CHAR && glyphs[c - FIRST_CHAR].present) {
+        return glyphs[c - FIRST_CHAR];
+    }
+    return glyphs['?' - FIRST_CHAR];
+}
+
+void GlyphAtlas::layout(const std::string& text, std::vector<GlyphQuad>& quads, int& width, int& height) const {
+    int penX = 0, penY = 0;
+    width = 0;
+    height = text.empty() ? 0 : lineHeight;
+    for (char c : text) {
+        if (c == '\n') {
+            penX = 0;
+            penY += lineHeight;
+            height += lineHeight;
+            continue;
+        }
+        const Glyph& glyph = glyphFor(c);
+        if (!glyph.present) continue;
+        if (glyph.src.w > 0) {
+            quads.push_back({glyph.src, {penX, penY, glyph.src.w, glyph.src.h}});
+        }
+        penX += glyph.advance;
+        width = std::max(width, penX);
+    }
+}
+
+TextLabel::TextLabel(const GlyphAtlas* atlas, const std::string& text) :
+    atlas(atlas),
+    text(text)
+{
+    relayout();
+}
+
+void TextLabel::setAtlas(const GlyphAtlas* newAtlas) {
+    if (newAtlas == atlas) return;
+    atlas = newAtlas;
+    relayout();
+}
+
+void TextLabel::setText(const std::string& newText) {
+    if (newText == text) return;
+    text = newText;
+    relayout();
+}
+
+void TextLabel::relayout() {
+    quads.clear(); // Keeps its capacity for the next layout
+    width = height = 0;
+    if (atlas) {
+        atlas->layout(text, quads, width, height);
+    }
+}
+
+void TextLabel::draw(SDL_Renderer* renderer, int x, int y, SDL_Color color) const {
+    if (!atlas || quads.empty()) return;
+    SDL_Texture* texture = atlas->getTexture();
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+    for (const GlyphQuad& quad : quads) {
+        SDL_Rect dest = {x + quad.dest.x, y + quad.dest.y, quad.dest.w, quad.dest.h};
+        SDL_RenderCopy(renderer, texture, &quad.src, &dest);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <vector>
+
+// One glyph of a laid-out string: where it is on the atlas and where it goes
+// relative to the string's top-left corner
+struct GlyphQuad {
+    SDL_Rect src;
+    SDL_Rect dest;
+};
+
+// Every printable ASCII glyph of one font at one size, rasterized once into
+// a single white texture. Strings are drawn as copies out of it, tinted
+// with the texture's color mod, so showing text never creates a texture.
+//
+// Glyphs are placed at their advance with no kerning, which is exact for
+// the monospaced pixel fonts the game uses. Characters outside the atlas
+// are drawn as '?'.
+class GlyphAtlas {
+public:
+    static constexpr char FIRST_CHAR = ' ';
+    static constexpr char LAST_CHAR = '~';
+
+    GlyphAtlas(SDL_Renderer* renderer, TTF_Font* font);
+    ~GlyphAtlas();
+
+    // Owns the texture
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // Appends quads for `text` ('\n' starts a new line) and reports the
+    // size of the whole block
+    void layout(const std::string& text, std::vector<GlyphQuad>& quads, int& width, int& height) const;
+
+    SDL_Texture* getTexture() const { return texture; }
+    int getLineHeight() const { return lineHeight; }
+
+private:
+    struct Glyph {
+        SDL_Rect src{0, 0, 0, 0};
+        int advance = 0;
+        bool present = false;
+    };
+
+    SDL_Texture* texture = nullptr;
+    Glyph glyphs[LAST_CHAR - FIRST_CHAR + 1];
+    int lineHeight = 0;
+
+    const Glyph& glyphFor(char c) const;
+};
+
+// A string laid out against a GlyphAtlas. setText() only redoes the layout
+// when the text actually changed, so a HUD label can be set every frame and
+// drawing it is a handful of copies.
+class TextLabel {
+public:
+    explicit TextLabel(const GlyphAtlas* atlas = nullptr, const std::string& text = "");
+
+    void setAtlas(const GlyphAtlas* atlas);
+    void setText(const std::string& text);
+    const std::string& getText() const { return text; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    void draw(SDL_Renderer* renderer, int x, int y, SDL_Color color) const;
+
+private:
+    const GlyphAtlas* atlas;
+    std::string text;
+    std::vector<GlyphQuad> quads;
+    int width = 0;
+    int height = 0;
+
+    void relayout();
+};
@@ -1,41 +1,93 @@
 #include "input.h"
 #include <SDL2/SDL.h>
 
-void InputHandler::handle_keydown(SDL_Keycode key) {
-    SDL_Scancode scancode = SDL_GetScancodeFromKey(key);
-    if (scancode < SDL_NUM_SCANCODES) {
-        key_states[scancode] = 1;
+void InputHandler::handle_event(const SDL_Event& event) {
+    switch (event.type) {
+    case SDL_KEYDOWN:
+        if (!event.key.repeat) {
+            handle_keydown(event.key.keysym.scancode, event.key.timestamp);
+        }
+        break;
+    case SDL_KEYUP:
+        handle_keyup(event.key.keysym.scancode, event.key.timestamp);
+        break;
+    case SDL_MOUSEMOTION:
+        handle_mousemotion(event.motion.x, event.motion.y);
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+        handle_mousebuttondown(event.button.button, event.button.x, event.button.y, event.button.timestamp);
+        break;
+    case SDL_MOUSEBUTTONUP:
+        handle_mousebuttonup(event.button.button, event.button.x, event.button.y, event.button.timestamp);
+        break;
     }
 }
 
-void InputHandler::handle_keyup(SDL_Keycode key) {
-    SDL_Scancode scancode = SDL_GetScancodeFromKey(key);
-    if (scancode < SDL_NUM_SCANCODES) {
-        key_states[scancode] = 0;
+void InputHandler::handle_keydown(SDL_Scancode key, Uint32 timestamp) {
+    if (key < SDL_NUM_SCANCODES) {
+        push({timestamp, static_cast<Uint16>(key), false, true});
+    }
+}
+
+void InputHandler::handle_keyup(SDL_Scancode key, Uint32 timestamp) {
+    if (key < SDL_NUM_SCANCODES) {
+        push({timestamp, static_cast<Uint16>(key), false, false});
     }
 }
 
 void InputHandler::handle_mousemotion(int x, int y) {
+    // Position isn't an edge; the latest is always the one wanted
     mouse_x = x;
     mouse_y = y;
 }
 
-void InputHandler::handle_mousebuttondown(Uint8 button, int x, int y) {
-    if (button <= 4) {
-        mouse_button_states[button] = 1;
+void InputHandler::handle_mousebuttondown(Uint8 button, int x, int y, Uint32 timestamp) {
+    if (button < MOUSE_BUTTONS) {
+        push({timestamp, button, true, true});
     }
     mouse_x = x;
     mouse_y = y;
 }
 
-void InputHandler::handle_mousebuttonup(Uint8 button, int x, int y) {
-    if (button <= 4) {
-        mouse_button_states[button] = 0;
+void InputHandler::handle_mousebuttonup(Uint8 button, int x, int y, Uint32 timestamp) {
+    if (button < MOUSE_BUTTONS) {
+        push({timestamp, button, true, false});
     }
     mouse_x = x;
     mouse_y = y;
 }
 
+void InputHandler::push(const Event& event) {
+    if (queue_count == QUEUE_SIZE) {
+        // Full: the oldest event lands in the current tick rather than being lost
+        apply(queue[queue_head], tick);
+        queue_head = (queue_head + 1) % QUEUE_SIZE;
+        --queue_count;
+    }
+    queue[(queue_head + queue_count) % QUEUE_SIZE] = event;
+    ++queue_count;
+}
+
+void InputHandler::apply(const Event& event, Uint32 in_tick) {
+    if (event.mouse) {
+        mouse_button_states[event.code] = event.down ? 1 : 0;
+        (event.down ? mouse_pressed_tick : mouse_released_tick)[event.code] = in_tick;
+    } else {
+        key_states[event.code] = event.down ? 1 : 0;
+        (event.down ? key_pressed_tick : key_released_tick)[event.code] = in_tick;
+    }
+}
+
+void InputHandler::begin_tick(Uint32 until) {
+    ++tick;
+    // Events arrive in timestamp order, so stop at the first later one
+    while (queue_count > 0 && SDL_TICKS_PASSED(until, queue[queue_head].timestamp)) {
+        apply(queue[queue_head], tick);
+        queue_head = (queue_head + 1) % QUEUE_SIZE;
+        --queue_count;
+    }
+}
+
 bool InputHandler::is_key_pressed(SDL_Scancode key) const {
     if (key < SDL_NUM_SCANCODES) {
         return key_states[key] == 1;
@@ -43,13 +95,29 @@ bool InputHandler::is_key_pressed(SDL_Scancode key) const {
     return false;
 }
 
+bool InputHandler::pressed_this_tick(SDL_Scancode key) const {
+    return key < SDL_NUM_SCANCODES && key_pressed_tick[key] == tick;
+}
+
+bool InputHandler::released_this_tick(SDL_Scancode key) const {
+    return key < SDL_NUM_SCANCODES && key_released_tick[key] == tick;
+}
+
 bool InputHandler::is_mouse_button_pressed(Uint8 button) const {
-    if (button <= 4) {
+    if (button < MOUSE_BUTTONS) {
         return mouse_button_states[button] == 1;
     }
     return false;
 }
 
+bool InputHandler::mouse_pressed_this_tick(Uint8 button) const {
+    return button < MOUSE_BUTTONS && mouse_pressed_tick[button] == tick;
+}
+
+bool InputHandler::mouse_released_this_tick(Uint8 button) const {
+    return button < MOUSE_BUTTONS && mouse_released_tick[button] == tick;
+}
+
 std::pair<int, int> InputHandler::get_mouse_position() const {
     return std::make_pair(mouse_x, mouse_y);
 }
@@ -1,24 +1,74 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include <utility> // For std::pair
 
+// Keyboard and mouse state, fed from SDL events and read by the game one
+// simulation tick at a time.
+//
+// Button presses and releases are queued with their SDL timestamps in a
+// ring buffer instead of being applied as they arrive. begin_tick(until)
+// applies everything up to `until` and starts a new tick, so:
+//  - is_key_pressed() is the state at the end of that tick
+//  - pressed_this_tick()/released_this_tick() report the edges that
+//    happened during it, so a tap that goes down and up between two ticks
+//    is still seen (pressed and released this tick, not held)
+//  - a fixed-step loop running several steps in one frame passes each
+//    step's end time and every event lands in the step it happened in
+// Keys are scancodes (physical positions), taken straight from the event,
+// so WASD-style bindings work on any keyboard layout.
 class InputHandler
 {
 public:
+    // Events held between ticks; older ones are applied early when it fills
+    static constexpr int QUEUE_SIZE = 256;
+    static constexpr int MOUSE_BUTTONS = 5; // SDL_BUTTON_LEFT .. SDL_BUTTON_X1
+
     InputHandler() = default;
     ~InputHandler() = default;
 
-    void handle_keydown(SDL_Keycode key);
-    void handle_keyup(SDL_Keycode key);
+    // Feeds any SDL event; ignores the ones that aren't input, and key repeats
+    void handle_event(const SDL_Event& event);
+    void handle_keydown(SDL_Scancode key, Uint32 timestamp);
+    void handle_keyup(SDL_Scancode key, Uint32 timestamp);
     void handle_mousemotion(int x, int y);
-    void handle_mousebuttondown(Uint8 button, int x, int y);
-    void handle_mousebuttonup(Uint8 button, int x, int y);
+    void handle_mousebuttondown(Uint8 button, int x, int y, Uint32 timestamp);
+    void handle_mousebuttonup(Uint8 button, int x, int y, Uint32 timestamp);
+
+    // Applies queued events stamped at or before `until` (SDL_GetTicks time)
+    // and makes them this tick's edges
+    void begin_tick(Uint32 until);
+    Uint32 get_tick() const { return tick; }
 
     bool is_key_pressed(SDL_Scancode key) const;
+    bool pressed_this_tick(SDL_Scancode key) const;
+    bool released_this_tick(SDL_Scancode key) const;
     bool is_mouse_button_pressed(Uint8 button) const;
+    bool mouse_pressed_this_tick(Uint8 button) const;
+    bool mouse_released_this_tick(Uint8 button) const;
     std::pair<int, int> get_mouse_position() const;
 
 private:
+    struct Event {
+        Uint32 timestamp;
+        Uint16 code;  // Scancode, or mouse button
+        bool mouse;
+        bool down;
+    };
+
     int mouse_x = 0, mouse_y = 0;
     Uint8 key_states[SDL_NUM_SCANCODES] = {0};
-    Uint8 mouse_button_states[5] = {0};
-};
\ No newline at end of file
+    Uint8 mouse_button_states[MOUSE_BUTTONS] = {0};
+    // Tick each key/button last went down or up in; 0 = never
+    Uint32 key_pressed_tick[SDL_NUM_SCANCODES] = {0};
+    Uint32 key_released_tick[SDL_NUM_SCANCODES] = {0};
+    Uint32 mouse_pressed_tick[MOUSE_BUTTONS] = {0};
+    Uint32 mouse_released_tick[MOUSE_BUTTONS] = {0};
+
+    Event queue[QUEUE_SIZE];
+    int queue_head = 0;  // Oldest event
+    int queue_count = 0;
+    Uint32 tick = 1;     // Ticks start at 1 so the zeroed tables mean "never"
+
+    void push(const Event& event);
+    void apply(const Event& event, Uint32 in_tick);
+};
@@ -0,0 +1,145 @@
+#include "layered_map.h"
+#include <algorithm> // For std::find, std::max, std::min
+#include <cmath>     // For std::floor
+#include <stdexcept>
+
+LayeredMap::LayeredMap(
+    int tile_width, int tile_height, int map_width, int map_height,
+    const std::vector<CollisionLayer>& collision_lut
+) :
+    tile_width(tile_width),
+    tile_height(tile_height),
+    map_width(map_width),
+    map_height(map_height),
+    collisionLut(collision_lut),
+    palette(1, CollisionLayer::NONE),
+    collision(nullptr, tile_width, tile_height, map_width, map_height, palette)
+{}
+
+int LayeredMap::addLayer(
+    const std::string& name, Spritesheet* sheet, const std::vector<int>& tiles, bool collides
+) {
+    if (tiles.size() != static_cast<size_t>(map_width) * map_height) {
+        throw std::runtime_error("Layer '" + name + "' doesn't match the map size.");
+    }
+
+    Layer layer;
+    layer.name = name;
+    layer.collides = collides;
+    // Layers only hold tile indices; collision lives in the merged map
+    layer.tiles = std::make_unique<Tilemap>(sheet, tile_width, tile_height, map_width, map_height, std::vector<CollisionLayer>());
+    layer.tiles->setTiles({0, 0, map_width, map_height}, tiles.data());
+    layer.tiles->validateFrames();
+    layers.push_back(std::move(layer));
+
+    if (collides) {
+        mergeRegion({0, 0, map_width, map_height});
+    }
+    return static_cast<int>(layers.size()) - 1;
+}
+
+int LayeredMap::addLayer(
+    const std::string& name, Spritesheet* sheet, const TextMap& map, bool collides
+) {
+    if (map.width != map_width || map.height != map_height) {
+        throw std::runtime_error(
+            "Layer '" + name + "' is " + std::to_string(map.width) + "x" +
+            std::to_string(map.height) + ", the map is " + std::to_string(map_width) +
+            "x" + std::to_string(map_height) + "."
+        );
+    }
+    return addLayer(name, sheet, map.tiles, collides);
+}
+
+int LayeredMap::findLayer(const std::string& name) const {
+    for (size_t i = 0; i < layers.size(); ++i) {
+        if (layers[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void LayeredMap::setLayerParallax(int layer, float factorX, float factorY) {
+    layers[layer].parallaxX = factorX;
+    layers[layer].parallaxY = factorY;
+}
+
+void LayeredMap::setLayerVisible(int layer, bool visible) {
+    layers[layer].visible = visible;
+}
+
+void LayeredMap::setTile(int layer, int tileX, int tileY, int tile_index) {
+    setTiles(layer, {tileX, tileY, 1, 1}, tile_index);
+}
+
+void LayeredMap::setTiles(int layer, const TileRect& region, int tile_index) {
+    layers[layer].tiles->setTiles(region, tile_index);
+    if (layers[layer].collides) {
+        mergeRegion(region);
+    }
+}
+
+int LayeredMap::paletteIndex(CollisionLayer combined) {
+    if (combined == CollisionLayer::NONE) return -1; // Empty cell
+    auto it = std::find(palette.begin(), palette.end(), combined);
+    if (it != palette.end()) return static_cast<int>(it - palette.begin());
+    palette.push_back(combined);
+    return static_cast<int>(palette.size()) - 1;
+}
+
+void LayeredMap::mergeRegion(const TileRect& region) {
+    int x0 = std::max(region.x, 0);
+    int y0 = std::max(region.y, 0);
+    int x1 = std::min(region.x + region.w, map_width);
+    int y1 = std::min(region.y + region.h, map_height);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    std::vector<int> merged(static_cast<size_t>(x1 - x0) * (y1 - y0));
+    size_t paletteSize = palette.size();
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            CollisionLayer combined = CollisionLayer::NONE;
+            for (const Layer& layer : layers) {
+                if (layer.collides) combined |= layerOfTile(layer.tiles->getTile(x, y));
+            }
+            merged[(y - y0) * (x1 - x0) + (x - x0)] = paletteIndex(combined);
+        }
+    }
+
+    // New combinations are rare (a handful per tileset), so growing the
+    // collision map's table and rebuilding it is fine
+    if (palette.size() != paletteSize) {
+        collision.setCollisionLut(palette);
+    }
+    collision.setTiles({x0, y0, x1 - x0, y1 - y0}, merged.data());
+}
+
+void LayeredMap::draw(SDL_Renderer* renderer, float cameraX, float cameraY) const {
+    for (const Layer& layer : layers) {
+        if (!layer.visible) continue;
+        // Collision-only layers have no sheet and draw nothing
+        layer.tiles->draw(
+            renderer,
+            static_cast<int>(std::floor(-cameraX * layer.parallaxX)),
+            static_cast<int>(std::floor(-cameraY * layer.parallaxY))
+        );
+    }
+}
+
+void LayeredMap::setAnimator(const TileAnimator* animator) {
+    for (Layer& layer : layers) {
+        layer.tiles->setAnimator(animator);
+    }
+}
+
+void LayeredMap::invalidateRenderCache() {
+    for (Layer& layer : layers) {
+        layer.tiles->invalidateRenderCache();
+    }
+}
+
+void LayeredMap::flushChanges() {
+    for (Layer& layer : layers) {
+        layer.tiles->flushChanges();
+    }
+    collision.flushChanges();
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tilemap.h"
+#include "text_map.h"
+#include "collisions_defs.h"
+
+// A stack of same-sized tile layers drawn back to front, plus one merged
+// collision map. Every colliding layer's tiles are OR-ed together per cell
+// as layers are added, so physics asks one Tilemap one question instead of
+// checking each layer. Layers added without a spritesheet are
+// collision-only: they feed the merged map but are never drawn.
+//
+//   LayeredMap level(16, 16, width, height, tileset.getCollisionLut());
+//   level.addLayer("floor", &sheet, floorTiles, false);
+//   level.addLayer("walls", &sheet, wallTiles, true);
+//   level.addLayer("triggers", nullptr, triggerTiles, true);
+//   entityManager.update(level.getCollisionMap(), ...);
+//   level.draw(renderer, cameraX, cameraY);
+class LayeredMap {
+public:
+    LayeredMap(
+        int tile_width, int tile_height, int map_width, int map_height,
+        const std::vector<CollisionLayer>& collision_lut
+    );
+
+    LayeredMap(const LayeredMap&) = delete;
+    LayeredMap& operator=(const LayeredMap&) = delete;
+
+    // Adds a layer on top of the others and returns its index. `tiles` is
+    // row-major and must be map_width x map_height. A null `sheet` makes it
+    // collision-only; `collides` decides whether it feeds the collision map.
+    // Throws std::runtime_error on a size mismatch.
+    int addLayer(const std::string& name, Spritesheet* sheet, const std::vector<int>& tiles, bool collides);
+    int addLayer(const std::string& name, Spritesheet* sheet, const TextMap& map, bool collides);
+
+    int getLayerCount() const { return static_cast<int>(layers.size()); }
+    // Index of the layer with this name, or -1
+    int findLayer(const std::string& name) const;
+    const Tilemap& getLayer(int layer) const { return *layers[layer].tiles; }
+
+    // Parallax factor 1 scrolls with the camera, 0.5 at half speed, 0 not at all
+    void setLayerParallax(int layer, float factorX, float factorY);
+    void setLayerVisible(int layer, bool visible);
+    bool isLayerVisible(int layer) const { return layers[layer].visible; }
+
+    // Edits a layer and keeps the merged collision cell in step
+    void setTile(int layer, int tileX, int tileY, int tile_index);
+    void setTiles(int layer, const TileRect& region, int tile_index);
+
+    // Merged collision of every colliding layer, for entity updates and
+    // collision/raycast/visibility queries. Its tile values are internal.
+    Tilemap* getCollisionMap() { return &collision; }
+    const Tilemap* getCollisionMap() const { return &collision; }
+
+    int getTileWidth() const { return tile_width; }
+    int getTileHeight() const { return tile_height; }
+    int getMapWidth() const { return map_width; }
+    int getMapHeight() const { return map_height; }
+
+    // Draws every visible layer in order, each offset by the camera times
+    // its parallax factor
+    void draw(SDL_Renderer* renderer, float cameraX, float cameraY) const;
+
+    void setAnimator(const TileAnimator* animator);
+    void invalidateRenderCache();
+    // Tilemap::flushChanges() for every layer and the collision map
+    void flushChanges();
+
+private:
+    struct Layer {
+        std::string name;
+        std::unique_ptr<Tilemap> tiles;
+        float parallaxX = 1.0f;
+        float parallaxY = 1.0f;
+        bool visible = true;
+        bool collides = false;
+    };
+
+    int tile_width;
+    int tile_height;
+    int map_width;
+    int map_height;
+    std::vector<CollisionLayer> collisionLut; // Tile index -> layer
+    std::vector<Layer> layers;
+
+    // The collision map's tiles are indices into this palette of merged
+    // layer combinations (entry 0 is NONE); it is the collision map's LUT
+    std::vector<CollisionLayer> palette;
+    Tilemap collision;
+
+    CollisionLayer layerOfTile(int tileIndex) const {
+        return (static_cast<unsigned>(tileIndex) < collisionLut.size())
+                   ? collisionLut[tileIndex]
+                   : CollisionLayer::NONE;
+    }
+    // Palette index for a combination, adding it if it's new
+    int paletteIndex(CollisionLayer combined);
+    // Recomputes merged cells in a region from every colliding layer
+    void mergeRegion(const TileRect& region);
+};
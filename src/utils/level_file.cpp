@@ -0,0 +1,169 @@
+#include "level_file.h"
+#include <algorithm> // For std::min
+#include <cstring>   // For std::memcmp
+#include <stdexcept>
+#include <string>
+#include "tilemap.h" // For Tilemap::CHUNK_TILES
+
+using namespace level_format;
+
+static_assert(CHUNK_COLUMNS == Tilemap::CHUNK_TILES, "Level chunks must match Tilemap chunks");
+static_assert(sizeof(int) == sizeof(int32_t), "Tile layers are used in place as int arrays");
+
+LevelFile::LevelFile(const char* path) : file(path) {
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error(std::string("Level file is too small: ") + path);
+    }
+    header = section<Header>(0);
+    validate(path);
+    layers = section<LayerEntry>(header->layersOffset);
+}
+
+// Checks everything the accessors rely on, so they can index the mapping
+// without further bounds checks
+void LevelFile::validate(const char* path) const {
+    auto fail = [path](const char* reason) {
+        throw std::runtime_error(std::string("Invalid level file ") + path + ": " + reason);
+    };
+
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) fail("bad magic");
+    if (header->byteOrder != BYTE_ORDER_MARK) fail("written with a different byte order");
+    if (header->version != VERSION) fail("unsupported version, recompile it with levelc");
+    if (header->fileSize != file.size()) fail("truncated");
+    if (header->width <= 0 || header->height <= 0 || header->tileWidth <= 0 || header->tileHeight <= 0) {
+        fail("bad dimensions");
+    }
+
+    const uint64_t size = file.size();
+    // Sections must be aligned and fit in the file. Counts are 32-bit, so
+    // count * record size can't overflow 64 bits.
+    auto checkSection = [&](uint64_t offset, uint64_t bytes) {
+        if (offset % SECTION_ALIGN != 0 || offset > size || bytes > size - offset) {
+            fail("section out of range");
+        }
+    };
+    checkSection(header->layersOffset, uint64_t(header->layerCount) * sizeof(LayerEntry));
+    checkSection(header->lutOffset, uint64_t(header->lutCount) * sizeof(uint32_t));
+    checkSection(header->spawnsOffset, uint64_t(header->spawnCount) * sizeof(SpawnEntry));
+    checkSection(header->chunksOffset, uint64_t(header->chunkCount) * sizeof(ChunkEntry));
+    checkSection(header->stringsOffset, header->stringsSize);
+
+    // Every string offset is checked below, and the table must end in a NUL
+    // so a string can't run off the end
+    if (header->stringsSize == 0 || file.data()[header->stringsOffset + header->stringsSize - 1] != '\0') {
+        fail("bad string table");
+    }
+    auto checkString = [&](uint32_t offset) {
+        if (offset >= header->stringsSize) fail("string out of range");
+    };
+
+    const uint64_t cells = uint64_t(header->width) * uint64_t(header->height);
+    const LayerEntry* layerTable = section<LayerEntry>(header->layersOffset);
+    for (uint32_t i = 0; i < header->layerCount; ++i) {
+        checkString(layerTable[i].nameOffset);
+        checkSection(layerTable[i].tilesOffset, cells * sizeof(int32_t));
+        checkSection(layerTable[i].flipsOffset, cells);
+    }
+
+    const SpawnEntry* spawnTable = section<SpawnEntry>(header->spawnsOffset);
+    for (uint32_t i = 0; i < header->spawnCount; ++i) {
+        checkString(spawnTable[i].nameOffset);
+        checkString(spawnTable[i].typeOffset);
+        checkString(spawnTable[i].groupOffset);
+    }
+
+    const uint64_t expectedChunks = (uint64_t(header->width) + CHUNK_COLUMNS - 1) / CHUNK_COLUMNS;
+    if (header->chunkCount != expectedChunks) fail("chunk index doesn't match the width");
+    const ChunkEntry* chunkTable = section<ChunkEntry>(header->chunksOffset);
+    for (uint32_t i = 0; i < header->chunkCount; ++i) {
+        if (chunkTable[i].firstColumn != int32_t(i) * CHUNK_COLUMNS || chunkTable[i].columns <= 0 ||
+            chunkTable[i].columns > CHUNK_COLUMNS ||
+            chunkTable[i].firstColumn + chunkTable[i].columns > header->width) {
+            fail("bad chunk entry");
+        }
+    }
+}
+
+const char* LevelFile::string(uint32_t offset) const {
+    return section<char>(header->stringsOffset) + offset;
+}
+
+int LevelFile::findLayer(std::string_view layerName) const {
+    for (int i = 0; i < getLayerCount(); ++i) {
+        if (layerName == string(layers[i].nameOffset)) return i;
+    }
+    return -1;
+}
+
+const char* LevelFile::getLayerName(int layer) const {
+    return string(layers[layer].nameOffset);
+}
+
+bool LevelFile::isLayerVisible(int layer) const {
+    return (layers[layer].flags & LAYER_VISIBLE) != 0;
+}
+
+float LevelFile::getLayerOpacity(int layer) const {
+    return layers[layer].opacity;
+}
+
+int* LevelFile::getLayerTiles(int layer) {
+    // Writable thanks to the copy-on-write mapping
+    return reinterpret_cast<int*>(file.data() + layers[layer].tilesOffset);
+}
+
+const int* LevelFile::getLayerTiles(int layer) const {
+    return section<int>(layers[layer].tilesOffset);
+}
+
+const uint8_t* LevelFile::getLayerFlips(int layer) const {
+    return section<uint8_t>(layers[layer].flipsOffset);
+}
+
+std::vector<CollisionLayer> LevelFile::getCollisionLut() const {
+    const uint32_t* lut = section<uint32_t>(header->lutOffset);
+    std::vector<CollisionLayer> result(header->lutCount);
+    for (uint32_t i = 0; i < header->lutCount; ++i) {
+        result[i] = static_cast<CollisionLayer>(lut[i]);
+    }
+    return result;
+}
+
+std::vector<SpawnPoint> LevelFile::getSpawnPoints() const {
+    const SpawnEntry* spawnTable = section<SpawnEntry>(header->spawnsOffset);
+    std::vector<SpawnPoint> result(header->spawnCount);
+    for (uint32_t i = 0; i < header->spawnCount; ++i) {
+        const SpawnEntry& entry = spawnTable[i];
+        result[i].name = string(entry.nameOffset);
+        result[i].type = string(entry.typeOffset);
+        result[i].group = string(entry.groupOffset);
+        result[i].x = entry.x;
+        result[i].y = entry.y;
+        result[i].width = entry.width;
+        result[i].height = entry.height;
+    }
+    return result;
+}
+
+const ChunkEntry& LevelFile::getChunk(int chunkIndex) const {
+    return section<ChunkEntry>(header->chunksOffset)[chunkIndex];
+}
+
+bool LevelFile::readChunk(
+    int layer, int chunkIndex, int width, int height, std::vector<int>& tiles
+) const {
+    if (chunkIndex < 0 || chunkIndex >= getChunkCount() || layer < 0 || layer >= getLayerCount()) {
+        return false;
+    }
+    const ChunkEntry& chunk = getChunk(chunkIndex);
+    const int* source = getLayerTiles(layer);
+    int columns = std::min(width, static_cast<int>(chunk.columns));
+    int rows = std::min(height, header->height);
+
+    tiles.assign(static_cast<size_t>(width) * height, -1);
+    for (int y = 0; y < rows; ++y) {
+        const int* row = source + static_cast<size_t>(y) * header->width + chunk.firstColumn;
+        std::copy(row, row + columns, tiles.begin() + static_cast<size_t>(y) * width);
+    }
+    return true;
+}
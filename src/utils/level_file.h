@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "collisions_defs.h"
+#include "level_format.h"
+#include "mapped_file.h"
+#include "tmx_map.h" // For SpawnPoint
+
+// A compiled level (see level_format.h) mapped straight into memory.
+// Nothing is parsed or copied on load beyond validating the header; the
+// tile layers are used in place, e.g. as a Tilemap's tile storage:
+//   LevelFile level("assets/levels/demo.lvl");
+//   Tilemap map(&sheet, level.getTileWidth(), level.getTileHeight(),
+//               level.getWidth(), level.getHeight(), level.getCollisionLut(),
+//               level.getLayerTiles(0));
+// The mapping is copy-on-write, so editing tiles never modifies the file.
+// The LevelFile must outlive anything viewing its layers.
+class LevelFile {
+public:
+    explicit LevelFile(const char* path);
+
+    LevelFile(const LevelFile&) = delete;
+    LevelFile& operator=(const LevelFile&) = delete;
+
+    int getWidth() const { return header->width; }
+    int getHeight() const { return header->height; }
+    int getTileWidth() const { return header->tileWidth; }
+    int getTileHeight() const { return header->tileHeight; }
+
+    int getLayerCount() const { return static_cast<int>(header->layerCount); }
+    // Index of the layer with this name, or -1
+    int findLayer(std::string_view layerName) const;
+    const char* getLayerName(int layer) const;
+    bool isLayerVisible(int layer) const;
+    float getLayerOpacity(int layer) const;
+    // Row-major tile ids, width * height of them, -1 for empty cells
+    int* getLayerTiles(int layer);
+    const int* getLayerTiles(int layer) const;
+    const uint8_t* getLayerFlips(int layer) const; // TileFlip bits
+
+    // Small tables, copied out for convenience
+    std::vector<CollisionLayer> getCollisionLut() const;
+    std::vector<SpawnPoint> getSpawnPoints() const;
+
+    int getChunkCount() const { return static_cast<int>(header->chunkCount); }
+    const level_format::ChunkEntry& getChunk(int chunkIndex) const;
+
+    // Copies one chunk of a layer into `tiles` (width x height, row-major),
+    // padding with -1. Matches LevelStreamer's ChunkSource, and only reads
+    // the mapping, so it is safe to call from the streaming thread.
+    bool readChunk(int layer, int chunkIndex, int width, int height, std::vector<int>& tiles) const;
+
+private:
+    MappedFile file;
+    const level_format::Header* header = nullptr;
+    const level_format::LayerEntry* layers = nullptr;
+
+    const char* string(uint32_t offset) const;
+    void validate(const char* path) const;
+
+    template <typename T>
+    const T* section(uint64_t offset) const {
+        return reinterpret_cast<const T*>(file.data() + offset);
+    }
+};
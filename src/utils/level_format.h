@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+
+// On-disk layout of a compiled level (.lvl), written offline by levelc
+// (tools/levelc) and memory-mapped at runtime by LevelFile.
+//
+// Every section starts on a SECTION_ALIGN boundary and holds plain
+// fixed-size records, so the arrays can be used in place straight out of
+// the mapping. Multi-byte values use the byte order of the machine that
+// wrote the file; BYTE_ORDER_MARK lets the loader reject a foreign one.
+//
+//   Header
+//   LayerEntry[layerCount]
+//   uint32_t   collisionLut[lutCount]   CollisionLayer bits per tile id
+//   SpawnEntry[spawnCount]
+//   ChunkEntry[chunkCount]
+//   per layer: int32_t tiles[width * height]  row-major, -1 = empty
+//              uint8_t flips[width * height]  TileFlip bits
+//   char       strings[stringsSize]     NUL-terminated names
+//
+// Bump VERSION whenever any of these records change.
+namespace level_format {
+
+constexpr char MAGIC[4] = {'U', 'G', 'L', 'V'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t SECTION_ALIGN = 64;
+
+// Width of a chunk index entry in columns (same as Tilemap::CHUNK_TILES)
+constexpr int CHUNK_COLUMNS = 32;
+
+// LayerEntry::flags
+constexpr uint32_t LAYER_VISIBLE = 1u << 0;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t fileSize;
+
+    int32_t width;      // In tiles, the same for every layer
+    int32_t height;
+    int32_t tileWidth;  // In pixels
+    int32_t tileHeight;
+
+    uint32_t layerCount;
+    uint32_t lutCount;
+    uint32_t spawnCount;
+    uint32_t chunkCount;
+
+    // Byte offsets from the start of the file
+    uint64_t layersOffset;
+    uint64_t lutOffset;
+    uint64_t spawnsOffset;
+    uint64_t chunksOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct LayerEntry {
+    uint32_t nameOffset; // Into the string table
+    uint32_t flags;
+    float opacity;
+    uint32_t reserved;
+    uint64_t tilesOffset;
+    uint64_t flipsOffset;
+};
+
+struct SpawnEntry {
+    uint32_t nameOffset;
+    uint32_t typeOffset;
+    uint32_t groupOffset;
+    float x; // World pixels
+    float y;
+    float width;
+    float height;
+    uint32_t reserved;
+};
+
+// Summary of one CHUNK_COLUMNS wide strip of the level, so streaming code
+// can see what a chunk holds without touching its tile pages
+struct ChunkEntry {
+    int32_t firstColumn;
+    int32_t columns;          // CHUNK_COLUMNS except for the last chunk
+    uint32_t collisionLayers; // Union of the layers of every tile in it
+    uint32_t tileCount;       // Non-empty cells over all layers
+};
+
+static_assert(sizeof(Header) == 104, "level_format::Header layout changed");
+static_assert(sizeof(LayerEntry) == 32, "level_format::LayerEntry layout changed");
+static_assert(sizeof(SpawnEntry) == 32, "level_format::SpawnEntry layout changed");
+static_assert(sizeof(ChunkEntry) == 16, "level_format::ChunkEntry layout changed");
+
+inline uint64_t alignUp(uint64_t offset) {
+    return (offset + SECTION_ALIGN - 1) & ~static_cast<uint64_t>(SECTION_ALIGN - 1);
+}
+
+} // namespace level_format
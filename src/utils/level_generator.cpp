@@ -0,0 +1,168 @@
+#include "level_generator.h"
+#include <algorithm> // For std::fill, std::max, std::min
+
+namespace {
+    // SplitMix64: tiny, fast and identical on every platform, unlike the
+    // standard distributions whose output is implementation-defined
+    struct Rng {
+        uint64_t state;
+
+        explicit Rng(uint64_t seed) : state(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform-enough integer in [lo, hi]; the modulo bias is irrelevant
+        // at these ranges
+        int range(int lo, int hi) {
+            if (hi <= lo) return lo;
+            return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1));
+        }
+    };
+
+    uint64_t mix(uint64_t seed, uint64_t a, uint64_t b) {
+        Rng rng(seed ^ (a * 0xD1B54A32D192ED03ull) ^ (b * 0x8CB92BA72F3D8DD7ull));
+        return rng.next();
+    }
+
+    constexpr uint64_t CHUNK_SALT = 1;
+    constexpr uint64_t SEAM_SALT = 2;
+
+    struct Room {
+        int x, y, w, h;
+        int centerX() const { return x + w / 2; }
+        int centerY() const { return y + h / 2; }
+    };
+
+    // Carves a two-tile-wide corridor from (x0, y0) to (x1, y1), running
+    // horizontally first when `horizontalFirst`, clamped inside the chunk
+    void carveCorridor(
+        std::vector<uint8_t>& floor, int width, int height,
+        int x0, int y0, int x1, int y1, bool horizontalFirst
+    ) {
+        auto carve = [&](int x, int y) {
+            for (int dy = 0; dy < 2; ++dy) {
+                for (int dx = 0; dx < 2; ++dx) {
+                    int cx = std::min(x + dx, width - 1);
+                    int cy = std::min(y + dy, height - 2);
+                    floor[cy * width + cx] = 1;
+                }
+            }
+        };
+        if (horizontalFirst) {
+            for (int x = std::min(x0, x1); x <= std::max(x0, x1); ++x) carve(x, y0);
+            for (int y = std::min(y0, y1); y <= std::max(y0, y1); ++y) carve(x1, y);
+        } else {
+            for (int y = std::min(y0, y1); y <= std::max(y0, y1); ++y) carve(x0, y);
+            for (int x = std::min(x0, x1); x <= std::max(x0, x1); ++x) carve(x, y1);
+        }
+    }
+}
+
+LevelGenerator::LevelGenerator(uint64_t seed, const GeneratorTiles& tiles, int chunkLimit) :
+    seed(seed),
+    tiles(tiles),
+    chunkLimit(chunkLimit)
+{}
+
+int LevelGenerator::seamRow(int seamIndex, int height) const {
+    // Rows 1..height-3 keep both corridor rows off the top and bottom walls
+    Rng rng(mix(seed, SEAM_SALT, static_cast<uint64_t>(seamIndex)));
+    return rng.range(1, std::max(1, height - 3));
+}
+
+bool LevelGenerator::generateChunk(
+    int chunkIndex, int width, int height, std::vector<int>& out,
+    std::vector<GeneratedSpawn>* spawns
+) const {
+    if (chunkIndex < 0 || (chunkLimit > 0 && chunkIndex >= chunkLimit)) return false;
+    out.assign(static_cast<size_t>(width) * height, tiles.empty);
+    if (width < 8 || height < 7) return true; // Too small for a room; solid rock
+
+    Rng rng(mix(seed, CHUNK_SALT, static_cast<uint64_t>(chunkIndex)));
+    std::vector<uint8_t> floor(static_cast<size_t>(width) * height, 0);
+
+    // Rooms: one per slot across the chunk, kept off the chunk's edges so
+    // only the seam corridors ever touch them
+    int roomCount = rng.range(1, std::max(1, std::min(3, (width - 2) / 8)));
+    int slotWidth = (width - 2) / roomCount;
+    std::vector<Room> rooms;
+    for (int i = 0; i < roomCount; ++i) {
+        int slotX = 1 + i * slotWidth;
+        Room room;
+        room.w = rng.range(4, std::max(4, slotWidth - 2));
+        room.h = rng.range(3, std::max(3, std::min(10, height - 4)));
+        room.x = rng.range(slotX + 1, slotX + slotWidth - room.w - 1);
+        room.y = rng.range(2, height - room.h - 2);
+        for (int y = room.y; y < room.y + room.h; ++y) {
+            std::fill(floor.begin() + y * width + room.x, floor.begin() + y * width + room.x + room.w, 1);
+        }
+        rooms.push_back(room);
+    }
+
+    // Corridors: in from the left seam, room to room, out at the right
+    // seam. The seam legs run along the seam row at the edges, so the only
+    // edge cells that are floor are the two seam rows both chunks agree on.
+    int leftSeam = seamRow(chunkIndex, height);
+    int rightSeam = seamRow(chunkIndex + 1, height);
+    carveCorridor(floor, width, height, 0, leftSeam, rooms.front().centerX(), rooms.front().centerY(), true);
+    for (size_t i = 1; i < rooms.size(); ++i) {
+        carveCorridor(
+            floor, width, height,
+            rooms[i - 1].centerX(), rooms[i - 1].centerY(), rooms[i].centerX(), rooms[i].centerY(),
+            (rng.next() & 1) != 0
+        );
+    }
+    carveCorridor(floor, width, height, rooms.back().centerX(), rooms.back().centerY(), width - 1, rightSeam, false);
+
+    // Floor outside the chunk is exactly the neighbour's seam corridor,
+    // which is what lets walls auto-tile across the seam
+    auto isFloor = [&](int x, int y) -> bool {
+        if (y < 0 || y >= height) return false;
+        if (x < 0) return y == leftSeam || y == leftSeam + 1;
+        if (x >= width) return y == rightSeam || y == rightSeam + 1;
+        return floor[y * width + x] != 0;
+    };
+
+    // Auto-tile: floor stays floor, anything touching floor becomes the wall
+    // variant for its orthogonal neighbours, the rest stays empty rock
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int& cell = out[y * width + x];
+            if (floor[y * width + x]) {
+                cell = tiles.floor;
+                continue;
+            }
+            int mask = (isFloor(x, y - 1) ? 1 : 0) | (isFloor(x + 1, y) ? 2 : 0) |
+                       (isFloor(x, y + 1) ? 4 : 0) | (isFloor(x - 1, y) ? 8 : 0);
+            bool touchesFloor = mask != 0 ||
+                isFloor(x - 1, y - 1) || isFloor(x + 1, y - 1) ||
+                isFloor(x - 1, y + 1) || isFloor(x + 1, y + 1);
+            if (touchesFloor) {
+                cell = tiles.walls[mask] >= 0 ? tiles.walls[mask] : tiles.wall;
+            }
+        }
+    }
+
+    // Enemies: up to two per room, never in the first room of the first
+    // chunk where the player walks in
+    if (spawns) {
+        int worldX = chunkIndex * width;
+        for (size_t i = 0; i < rooms.size(); ++i) {
+            if (chunkIndex == 0 && i == 0) continue;
+            const Room& room = rooms[i];
+            int count = rng.range(0, 2);
+            for (int n = 0; n < count; ++n) {
+                GeneratedSpawn spawn;
+                spawn.tileX = worldX + rng.range(room.x, room.x + room.w - 1);
+                spawn.tileY = rng.range(room.y, room.y + room.h - 1);
+                spawns->push_back(spawn);
+            }
+        }
+    }
+    return true;
+}
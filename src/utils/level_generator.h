@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Tile ids the generator paints with
+struct GeneratorTiles {
+    int floor = 38;
+    int empty = 41; // Solid rock away from any floor (not collidable)
+    int wall = 26;  // Wall whose shape has no variant below
+    // Wall variants by which of the 4 neighbours are floor: bit 0 north,
+    // 1 east, 2 south, 3 west. -1 falls back to `wall`. The defaults follow
+    // the dungeon tileset's 3x3 block of solid edge pieces (ids 0-8).
+    int walls[16] = {
+        -1, 6, 3, 0,  // -, N, E, N+E
+        1, -1, 0, -1, // S, N+S, E+S, N+E+S
+        5, 8, -1, -1, // W, N+W, E+W, N+E+W
+        2, -1, -1, -1 // S+W, N+S+W, E+S+W, all
+    };
+};
+
+// Where the generator wants an enemy, in world tile coordinates
+struct GeneratedSpawn {
+    int tileX = 0;
+    int tileY = 0;
+};
+
+// Deterministic rooms-and-corridors generator for endless horizontal runs.
+// A level is a row of chunks; chunk k depends only on the seed and k, so
+// chunks can be made in any order, on any thread, and the same seed always
+// gives the same level. Neighbouring chunks agree on where the corridor
+// crosses their shared edge, so they join up without seeing each other.
+//
+// generateChunk has the same shape as LevelStreamer's ChunkSource:
+//   LevelGenerator generator(seed, tiles);
+//   LevelStreamer streamer(&map, [&generator](int c, int w, int h, std::vector<int>& t) {
+//       return generator.generateChunk(c, w, h, t);
+//   });
+class LevelGenerator {
+public:
+    // `chunkLimit` ends the level after that many chunks (0 = endless)
+    LevelGenerator(uint64_t seed, const GeneratorTiles& tiles, int chunkLimit = 0);
+
+    // Fills `out` (width x height, row-major) with chunk `chunkIndex` and
+    // appends its enemy spawns to `spawns` if given. Returns false past the
+    // end of the level. Safe to call concurrently (the generator is const).
+    bool generateChunk(
+        int chunkIndex, int width, int height, std::vector<int>& out,
+        std::vector<GeneratedSpawn>* spawns = nullptr
+    ) const;
+
+    uint64_t getSeed() const { return seed; }
+
+private:
+    uint64_t seed;
+    GeneratorTiles tiles;
+    int chunkLimit;
+
+    // Top row of the two-tile corridor crossing the left edge of chunk
+    // `seamIndex` (i.e. the right edge of chunk seamIndex - 1)
+    int seamRow(int seamIndex, int height) const;
+};
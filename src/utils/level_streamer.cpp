@@ -0,0 +1,123 @@
+#include "level_streamer.h"
+#include <algorithm> // For std::max, std::min
+#include <cmath>     // For std::floor
+
+LevelStreamer::LevelStreamer(
+    Tilemap* map, ChunkSource source, int lookahead, int keepBehind
+) :
+    map(map),
+    source(std::move(source)),
+    lookahead(std::max(0, lookahead)),
+    keepBehind(std::max(0, keepBehind)),
+    windowChunks(
+        (map->getMapWidth() + Tilemap::CHUNK_TILES - 1) / Tilemap::CHUNK_TILES
+    ),
+    committed(windowChunks, 0),
+    nextRequest(map->getOriginX() / Tilemap::CHUNK_TILES),
+    worker(&LevelStreamer::workerLoop, this) {}
+
+LevelStreamer::~LevelStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void LevelStreamer::update(float cameraX) {
+    const int chunkPixels = Tilemap::CHUNK_TILES * map->getTileWidth();
+    int cameraChunk = static_cast<int>(std::floor(cameraX / chunkPixels));
+    int windowFirst = map->getOriginX() / Tilemap::CHUNK_TILES;
+
+    // 1. Evict chunks that are far enough behind the camera
+    int wantedFirst = std::max(0, cameraChunk - keepBehind);
+    if (wantedFirst > windowFirst) {
+        int shift = wantedFirst - windowFirst;
+        map->scrollWindow(shift);
+        int kept = std::max(0, windowChunks - shift);
+        std::copy(committed.end() - kept, committed.end(), committed.begin());
+        std::fill(committed.begin() + kept, committed.end(), 0);
+        windowFirst = wantedFirst;
+    }
+    int windowEnd = windowFirst + windowChunks;
+
+    // 2. Collect finished chunks that now fall inside the window
+    std::vector<std::pair<int, std::vector<int>>> arrived;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        levelEnd = firstMissing;
+        for (auto it = ready.begin(); it != ready.end();) {
+            if (it->first < windowFirst) {
+                it = ready.erase(it); // Scrolled past before it arrived
+            } else if (it->first < windowEnd) {
+                arrived.emplace_back(it->first, std::move(it->second));
+                it = ready.erase(it);
+            } else {
+                break; // Ordered map: the rest are further ahead
+            }
+        }
+    }
+    for (const auto& chunk : arrived) {
+        commit(chunk.first, chunk.second);
+    }
+
+    // 3. Ask for everything up to the lookahead distance
+    int requestEnd = std::min(windowEnd + lookahead, levelEnd);
+    nextRequest = std::max(nextRequest, windowFirst);
+    if (nextRequest < requestEnd) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (; nextRequest < requestEnd; ++nextRequest) {
+                requests.push_back(nextRequest);
+            }
+        }
+        wake.notify_one();
+    }
+}
+
+bool LevelStreamer::isWindowLoaded() const {
+    int windowFirst = map->getOriginX() / Tilemap::CHUNK_TILES;
+    for (int slot = 0; slot < windowChunks; ++slot) {
+        if (!committed[slot] && windowFirst + slot < levelEnd) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LevelStreamer::commit(int chunkIndex, const std::vector<int>& tiles) {
+    int slot = chunkIndex - map->getOriginX() / Tilemap::CHUNK_TILES;
+    TileRect region{chunkIndex * Tilemap::CHUNK_TILES, 0, Tilemap::CHUNK_TILES, map->getMapHeight()};
+    map->setTiles(region, tiles.data());
+    committed[slot] = 1;
+}
+
+void LevelStreamer::workerLoop() {
+    const int width = Tilemap::CHUNK_TILES;
+    const int height = map->getMapHeight();
+
+    while (true) {
+        int chunkIndex;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            chunkIndex = requests.front();
+            requests.pop_front();
+            if (chunkIndex >= firstMissing) continue; // Past the end
+        }
+
+        // Produce the chunk without holding the lock
+        std::vector<int> tiles(width * height, -1);
+        bool produced = source(chunkIndex, width, height, tiles);
+        tiles.resize(width * height, -1); // Guard against short output
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (produced) {
+            ready[chunkIndex] = std::move(tiles);
+        } else {
+            firstMissing = std::min(firstMissing, chunkIndex);
+        }
+    }
+}
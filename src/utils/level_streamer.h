@@ -0,0 +1,69 @@
+#pragma once
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tilemap.h"
+
+// Produces one chunk of a level: a Tilemap::CHUNK_TILES wide, full-height
+// strip of tile indices, row-major. Runs on the streaming thread, so it must
+// not touch the Tilemap or the renderer. Returns false past the end of the
+// level.
+using ChunkSource = std::function<bool(
+    int chunkIndex, int width, int height, std::vector<int>& tiles
+)>;
+
+// Streams a horizontally scrolling level through a Tilemap window.
+// Chunks ahead of the camera are produced on a background thread and
+// committed on the main thread; chunks far enough behind the camera are
+// evicted by scrolling the window. Memory use depends only on the window
+// size and lookahead, not on the length of the level.
+class LevelStreamer {
+public:
+    // `lookahead` chunks past the right edge of the window are prepared
+    // ahead of time; `keepBehind` chunks left of the camera are kept before
+    // being evicted. The map's width should be a multiple of CHUNK_TILES.
+    LevelStreamer(Tilemap* map, ChunkSource source, int lookahead = 2, int keepBehind = 1);
+    ~LevelStreamer();
+
+    LevelStreamer(const LevelStreamer&) = delete;
+    LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+    // Call once per frame with the camera's left edge in world pixels.
+    // Scrolls the window, commits chunks that finished loading and queues
+    // the next ones. Listeners on the map hear about it at the next
+    // Tilemap::flushChanges().
+    void update(float cameraX);
+
+    // True once every chunk inside the window has been committed
+    bool isWindowLoaded() const;
+
+private:
+    Tilemap* map;
+    ChunkSource source;
+    int lookahead;
+    int keepBehind;
+    int windowChunks;
+
+    // Main thread only
+    std::vector<uint8_t> committed; // Per window slot
+    int nextRequest = 0;            // Next chunk index to ask the worker for
+    int levelEnd = INT_MAX;         // First chunk the source couldn't produce
+
+    // Shared with the worker, guarded by mutex
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<int> requests;
+    std::map<int, std::vector<int>> ready; // Chunk index -> tiles
+    int firstMissing = INT_MAX;
+    bool stopping = false;
+
+    std::thread worker; // Started last, after everything it uses
+
+    void workerLoop();
+    void commit(int chunkIndex, const std::vector<int>& tiles);
+};
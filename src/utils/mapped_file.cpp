@@ -0,0 +1,75 @@
+#include "mapped_file.h"
+#include <stdexcept>
+#include <string>
+#include <utility> // For std::swap
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const char* path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("Failed to open file: ") + path);
+    }
+    buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    bytes = buffer.data();
+    length = buffer.size();
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Failed to open file: ") + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error(std::string("Failed to stat file: ") + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        // Writable private mapping: writes go to copy-on-write pages
+        void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error(std::string("Failed to map file: ") + path);
+        }
+        bytes = static_cast<uint8_t*>(mapping);
+    }
+    close(fd); // The mapping keeps its own reference to the file
+#endif
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(bytes, other.bytes);
+        std::swap(length, other.length);
+        std::swap(buffer, other.buffer); // Heap data keeps its address
+    }
+    return *this;
+}
+
+void MappedFile::unmap() {
+#ifndef _WIN32
+    if (bytes) munmap(bytes, length);
+#endif
+    bytes = nullptr;
+    length = 0;
+    buffer.clear();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A whole file mapped into memory. The mapping is private (copy-on-write):
+// pages can be written through data(), but changes only touch this process's
+// copy of the page and never reach the file. Pages are faulted in on first
+// access, so "loading" a large file costs almost nothing up front.
+// Platforms without mmap read the file into a heap buffer instead.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const char* path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    uint8_t* data() { return bytes; }
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    uint8_t* bytes = nullptr;
+    size_t length = 0;
+    std::vector<uint8_t> buffer; // Only used without mmap
+
+    void unmap();
+};
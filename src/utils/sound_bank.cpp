@@ -0,0 +1,117 @@
+#include "sound_bank.h"
+#include <cstdint> // For UINT32_MAX, INT32_MAX
+#include <cstring> // For std::memcmp
+#include <stdexcept>
+
+using namespace sound_bank_format;
+
+SoundBank::SoundBank(const char* path) : file(path) {
+    if (file.size() < sizeof(Header)) {
+        throw std::runtime_error(std::string("Sound bank is too small: ") + path);
+    }
+    header = section<Header>(0);
+    validate(path);
+
+    // Samples are only any good in the format the mixer actually opened
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    if (!Mix_QuerySpec(&frequency, &format, &channels)) {
+        throw std::runtime_error(std::string("Sound bank needs the audio system open: ") + path);
+    }
+    if (frequency != header->frequency || format != header->format || channels != header->channels) {
+        throw std::runtime_error(
+            std::string("Sound bank ") + path + " was built for " +
+            std::to_string(header->frequency) + " Hz, " + std::to_string(header->channels) +
+            " channels; the mixer runs at " + std::to_string(frequency) + " Hz, " +
+            std::to_string(channels) + " channels. Rebuild it with soundbank --rate/--channels"
+        );
+    }
+
+    // Chunks point into the mapping; Mix_FreeChunk only frees the struct
+    const SoundEntry* entries = section<SoundEntry>(header->soundsOffset);
+    sounds.reserve(header->soundCount);
+    for (uint32_t i = 0; i < header->soundCount; ++i) {
+        Mix_Chunk* chunk = Mix_QuickLoad_RAW(
+            file.data() + entries[i].dataOffset, static_cast<Uint32>(entries[i].dataSize)
+        );
+        if (!chunk) {
+            throw std::runtime_error(std::string("Failed to wrap sound effect: ") + Mix_GetError());
+        }
+        sounds.emplace_back(
+            std::shared_ptr<Mix_Chunk>(chunk, Mix_FreeChunk), entries[i].priority, entries[i].maxVoices
+        );
+        sounds.back().setVolume(entries[i].volume);
+        soundNames.push_back(string(entries[i].nameOffset));
+    }
+}
+
+// Checks everything the accessors rely on, so they can index the mapping
+// without further bounds checks
+void SoundBank::validate(const char* path) const {
+    auto fail = [path](const char* reason) {
+        throw std::runtime_error(std::string("Invalid sound bank ") + path + ": " + reason);
+    };
+
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) fail("bad magic");
+    if (header->byteOrder != BYTE_ORDER_MARK) fail("written with a different byte order");
+    if (header->version != VERSION) fail("unsupported version, rebuild it with soundbank");
+    if (header->fileSize != file.size()) fail("truncated");
+
+    const uint64_t size = file.size();
+    auto checkSection = [&](uint64_t offset, uint64_t bytes) {
+        if (offset % SECTION_ALIGN != 0 || offset > size || bytes > size - offset) {
+            fail("section out of range");
+        }
+    };
+    checkSection(header->soundsOffset, uint64_t(header->soundCount) * sizeof(SoundEntry));
+    checkSection(header->musicOffset, uint64_t(header->musicCount) * sizeof(MusicEntry));
+    checkSection(header->stringsOffset, header->stringsSize);
+
+    if (header->stringsSize == 0 || file.data()[header->stringsOffset + header->stringsSize - 1] != '\0') {
+        fail("bad string table");
+    }
+    auto checkString = [&](uint32_t offset) {
+        if (offset >= header->stringsSize) fail("string out of range");
+    };
+
+    const SoundEntry* soundTable = section<SoundEntry>(header->soundsOffset);
+    for (uint32_t i = 0; i < header->soundCount; ++i) {
+        checkString(soundTable[i].nameOffset);
+        checkSection(soundTable[i].dataOffset, soundTable[i].dataSize);
+        // Mix_Chunk lengths are 32-bit
+        if (soundTable[i].dataSize > UINT32_MAX) fail("sound too long");
+    }
+    const MusicEntry* musicTable = section<MusicEntry>(header->musicOffset);
+    for (uint32_t i = 0; i < header->musicCount; ++i) {
+        checkString(musicTable[i].nameOffset);
+        checkSection(musicTable[i].dataOffset, musicTable[i].dataSize);
+        // SDL_RWFromConstMem takes an int size
+        if (musicTable[i].dataSize > INT32_MAX) fail("music track too long");
+    }
+}
+
+const char* SoundBank::string(uint32_t offset) const {
+    return section<char>(header->stringsOffset) + offset;
+}
+
+const SoundEffect* SoundBank::findSound(std::string_view name) const {
+    for (size_t i = 0; i < sounds.size(); ++i) {
+        if (soundNames[i] == name) return &sounds[i];
+    }
+    return nullptr;
+}
+
+const MusicEntry* SoundBank::findMusic(std::string_view name) const {
+    const MusicEntry* entries = section<MusicEntry>(header->musicOffset);
+    for (uint32_t i = 0; i < header->musicCount; ++i) {
+        if (name == string(entries[i].nameOffset)) return &entries[i];
+    }
+    return nullptr;
+}
+
+std::unique_ptr<MusicTrack> SoundBank::openMusic(std::string_view name) const {
+    const MusicEntry* entry = findMusic(name);
+    if (!entry) return nullptr;
+    return std::make_unique<MusicTrack>(file.data() + entry->dataOffset, static_cast<size_t>(entry->dataSize));
+}
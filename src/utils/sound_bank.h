@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "audio.h"
+#include "mapped_file.h"
+#include "sound_bank_format.h"
+
+// A packed sound bank (see sound_bank_format.h) mapped straight into
+// memory. Sound effects are wrapped as Mix_Chunks pointing into the
+// mapping (Mix_QuickLoad_RAW), so nothing is decoded or copied at startup;
+// music stays compressed and streams from the mapping.
+//
+//   SoundBank bank("assets/audio/game.sbk"); // After AudioSystem::init
+//   const SoundEffect* hit = bank.findSound("hit");
+//   std::unique_ptr<MusicTrack> theme = bank.openMusic("level");
+//
+// The bank must have been built for the mixer's output format and must
+// outlive every SoundEffect copied from it and every track it opened.
+// Construction maps, validates and wraps the samples without touching the
+// audio thread, so it can run on a loader thread.
+class SoundBank {
+public:
+    explicit SoundBank(const char* path);
+
+    SoundBank(const SoundBank&) = delete;
+    SoundBank& operator=(const SoundBank&) = delete;
+
+    int getSoundCount() const { return static_cast<int>(sounds.size()); }
+    // Null if the bank has no such sound
+    const SoundEffect* findSound(std::string_view name) const;
+
+    int getMusicCount() const { return static_cast<int>(header->musicCount); }
+    bool hasMusic(std::string_view name) const { return findMusic(name) != nullptr; }
+    // Opens a stream over the track's bytes, or null if there's no such track
+    std::unique_ptr<MusicTrack> openMusic(std::string_view name) const;
+
+private:
+    MappedFile file;
+    const sound_bank_format::Header* header = nullptr;
+    std::vector<std::string> soundNames;
+    std::vector<SoundEffect> sounds;
+
+    const char* string(uint32_t offset) const;
+    const sound_bank_format::MusicEntry* findMusic(std::string_view name) const;
+    void validate(const char* path) const;
+
+    template <typename T>
+    const T* section(uint64_t offset) const {
+        return reinterpret_cast<const T*>(file.data() + offset);
+    }
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+
+// On-disk layout of a sound bank (.sbk), written offline by soundbank
+// (tools/soundbank) and memory-mapped at runtime by SoundBank.
+//
+// Sound effects are stored already decoded to the mixer's output format
+// (the header's frequency/format/channels), so they play straight out of
+// the mapping. Music is stored as the original compressed file and
+// streamed. Sections start on SECTION_ALIGN boundaries; multi-byte values
+// use the byte order of the machine that wrote the file.
+//
+//   Header
+//   SoundEntry[soundCount]
+//   MusicEntry[musicCount]
+//   per sound: PCM samples
+//   per track: encoded file bytes (.mp3, .ogg, ...)
+//   char       strings[stringsSize]     NUL-terminated names
+//
+// Bump VERSION whenever any of these records change.
+namespace sound_bank_format {
+
+constexpr char MAGIC[4] = {'U', 'G', 'S', 'B'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t SECTION_ALIGN = 64;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t fileSize;
+
+    // Mixer output format the samples were decoded to (see Mix_QuerySpec)
+    int32_t frequency;
+    uint16_t format;
+    uint16_t channels;
+
+    uint32_t soundCount;
+    uint32_t musicCount;
+
+    // Byte offsets from the start of the file
+    uint64_t soundsOffset;
+    uint64_t musicOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct SoundEntry {
+    uint32_t nameOffset; // Into the string table
+    int32_t priority;    // SoundEffect defaults
+    int32_t maxVoices;
+    int32_t volume;
+    uint64_t dataOffset;
+    uint64_t dataSize;   // Bytes of PCM
+};
+
+struct MusicEntry {
+    uint32_t nameOffset;
+    uint32_t reserved;
+    uint64_t dataOffset;
+    uint64_t dataSize;   // Bytes of the encoded file
+    uint64_t reserved2;
+};
+
+static_assert(sizeof(Header) == 72, "sound_bank_format::Header layout changed");
+static_assert(sizeof(SoundEntry) == 32, "sound_bank_format::SoundEntry layout changed");
+static_assert(sizeof(MusicEntry) == 32, "sound_bank_format::MusicEntry layout changed");
+
+inline uint64_t alignUp(uint64_t offset) {
+    return (offset + SECTION_ALIGN - 1) & ~static_cast<uint64_t>(SECTION_ALIGN - 1);
+}
+
+} // namespace sound_bank_format
@@ -2,16 +2,36 @@
 #include<stdexcept>
 #include <iostream>
 
-Spritesheet::Spritesheet(SDL_Renderer *renderer, const char *path, int width, int height) {
-	texture = IMG_LoadTexture(renderer, path);
-	if (!texture) {
-		std::cerr << "Failed to load texture: " << path << std::endl;
-		std::cerr << "SDL_image Error: " << IMG_GetError() << std::endl;
+namespace {
+	const TextureAtlas *shared_atlas = nullptr;
+}
+
+void Spritesheet::useAtlas(const TextureAtlas *atlas) {
+	shared_atlas = atlas;
+}
 
-		throw std::runtime_error("Failed to load texture");
+Spritesheet::Spritesheet(SDL_Renderer *renderer, const char *path, int width, int height) {
+	const AtlasRegion *atlas_region = shared_atlas ? shared_atlas->find(path) : nullptr;
+	if (atlas_region) {
+		texture = atlas_region->texture;
+		owns_texture = false;
+		region = atlas_region->rect;
+	} else {
+		texture = IMG_LoadTexture(renderer, path);
+		if (!texture) {
+			std::cerr << "Failed to load texture: " << path << std::endl;
+			std::cerr << "SDL_image Error: " << IMG_GetError() << std::endl;
+
+			throw std::runtime_error("Failed to load texture");
+		}
+		owns_texture = true;
+		region.x = 0;
+		region.y = 0;
+		SDL_QueryTexture(texture, NULL, NULL, &region.w, &region.h);
 	}
 
-	SDL_QueryTexture(texture, NULL, NULL, &sheet_width, &sheet_height);
+	sheet_width = region.w;
+	sheet_height = region.h;
 
 	sprite_width = width;
 	sprite_height = height;
@@ -20,36 +40,16 @@ Spritesheet::Spritesheet(SDL_Renderer *renderer, const char *path, int width, in
 	cols = sheet_width / sprite_width;
 	rows = sheet_height / sprite_height;
 
-	src_rect.x = 0;
-	src_rect.y = 0;
-	src_rect.w = sprite_width;
-	src_rect.h = sprite_height;
+	// every frame's source rect, so drawing is a lookup
+	frames.reserve(rows * cols);
+	for (int y = 0; y < rows; ++y) {
+		for (int x = 0; x < cols; ++x) {
+			frames.push_back({region.x + x * sprite_width, region.y + y * sprite_height, sprite_width, sprite_height});
+		}
+	}
 }
 
 Spritesheet::~Spritesheet() {
-	SDL_DestroyTexture(texture);
-}
-
-void Spritesheet::select_sprite(int i) {
-	if (i < 0 || i >= rows * cols)
-		throw std::out_of_range("Sprite index out of range");
-
-	int x = i % cols;
-	int y = i / cols;
-
-	src_rect.x = x * sprite_width;
-	src_rect.y = y * sprite_height;
-}
-
-// draw sprite on provided renderer
-void Spritesheet::draw(SDL_Renderer *renderer, int dest_x, int dest_y, int dest_w, int dest_h, SDL_RendererFlip flip) {
-	SDL_Rect dest_rect;
-	// position to render at
-	dest_rect.x = dest_x;
-	dest_rect.y = dest_y;
-	// dimensions of sprite to draw
-	dest_rect.w = (dest_w == -1) ? sprite_width : dest_w;
-	dest_rect.h = (dest_h == -1) ? sprite_height : dest_h;
-
-	SDL_RenderCopyEx(renderer, texture, &src_rect, &dest_rect, 0, NULL, flip);
+	if (owns_texture)
+		SDL_DestroyTexture(texture);
 }
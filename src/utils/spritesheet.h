@@ -1,20 +1,44 @@
 #pragma once
 #include<SDL2/SDL_image.h>
 #include<SDL2/SDL.h>
+#include <vector>
+#include "texture_atlas.h"
 
 class Spritesheet {
 public:
 	// width and height are width/height of sprites
+	// If the image is in the atlas set with useAtlas(), the sheet draws from
+	// its region of the atlas page instead of loading a texture of its own
 	Spritesheet(SDL_Renderer *renderer, char const *path, int width, int height);
 	~Spritesheet();
 
-	void select_sprite(int i);
-	// draw sprite sheet on provided renderer
-	void draw(SDL_Renderer *renderer, int dest_x, int dest_y, int dest_w = -1, int dest_h = -1, SDL_RendererFlip flip = SDL_FLIP_NONE);
+	Spritesheet(const Spritesheet&) = delete;
+	Spritesheet& operator=(const Spritesheet&) = delete;
+
+	// Atlas that new sheets look their image up in (null for none). Not
+	// owned; it must outlive every sheet created from it, and be unset
+	// (useAtlas(nullptr)) before it's destroyed.
+	static void useAtlas(const TextureAtlas *atlas);
+
+	// Frames are numbered left to right, top to bottom
+	int getFrameCount() const { return static_cast<int>(frames.size()); }
+	bool isValidFrame(int frame) const { return static_cast<unsigned>(frame) < frames.size(); }
+	int getSpriteWidth() const { return sprite_width; }
+	int getSpriteHeight() const { return sprite_height; }
+
+	// draw one frame into dest on provided renderer. Doesn't touch the sheet,
+	// so any number of users can share it. `frame` must be valid: check
+	// frame indices once when a map or animation is loaded (isValidFrame),
+	// not on every draw.
+	void draw(SDL_Renderer *renderer, int frame, const SDL_Rect &dest, SDL_RendererFlip flip = SDL_FLIP_NONE) const {
+		SDL_RenderCopyEx(renderer, texture, &frames[frame], &dest, 0, NULL, flip);
+	}
 
 private:
 	SDL_Texture *texture;
-	SDL_Rect src_rect;
+	bool owns_texture;
+	SDL_Rect region; // Sheet's pixels within the texture
+	std::vector<SDL_Rect> frames; // Source rect of every frame, built on load
 
 	int sprite_width, sprite_height;
 	int sheet_width, sheet_height;
@@ -0,0 +1,100 @@
+#include "text_map.h"
+#include <algorithm> // For std::copy, std::max
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+std::runtime_error parseError(const char* sourceName, int line, const std::string& message) {
+    return std::runtime_error(std::string(sourceName) + ":" + std::to_string(line) + ": " + message);
+}
+} // namespace
+
+TextMap parseTextMap(std::string_view text, const char* sourceName) {
+    TextMap map;
+    // Every tile takes at least two characters ("0 "), so this is the only
+    // allocation the parse needs
+    map.tiles.reserve(text.size() / 2 + 1);
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+    int line = 1;
+    int rowLength = 0; // Tiles on the current line so far
+
+    // Closes the current line: the first non-empty row fixes the width,
+    // every later one has to match it
+    auto endRow = [&]() {
+        if (rowLength == 0) return; // Blank line
+        if (map.height == 0) {
+            map.width = rowLength;
+        } else if (rowLength != map.width) {
+            throw parseError(
+                sourceName, line,
+                "row has " + std::to_string(rowLength) + " tiles, expected " + std::to_string(map.width)
+            );
+        }
+        ++map.height;
+        rowLength = 0;
+    };
+
+    while (p < end) {
+        char c = *p;
+        if (c == '\n') {
+            endRow();
+            ++line;
+            ++p;
+        } else if (c == ' ' || c == '\t' || c == '\r' || c == ',') {
+            ++p;
+        } else {
+            int tile = 0;
+            auto result = std::from_chars(p, end, tile);
+            if (result.ec != std::errc()) {
+                const char* tokenEnd = p;
+                while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\t' && *tokenEnd != '\r' && *tokenEnd != '\n') {
+                    ++tokenEnd;
+                }
+                throw parseError(
+                    sourceName, line, "invalid tile index '" + std::string(p, tokenEnd) + "'"
+                );
+            }
+            map.tiles.push_back(tile);
+            ++rowLength;
+            p = result.ptr;
+        }
+    }
+    endRow(); // Last line may not end in a newline
+
+    if (map.height == 0) {
+        throw std::runtime_error(std::string(sourceName) + ": map has no tiles");
+    }
+    return map;
+}
+
+TextMap loadTextMap(const char* path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("Failed to open tilemap file: ") + path);
+    }
+    std::string contents(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(contents.data(), contents.size());
+    return parseTextMap(contents, path);
+}
+
+void padTextMap(TextMap& map, int width, int height) {
+    width = std::max(width, map.width);
+    height = std::max(height, map.height);
+    if (width == map.width && height == map.height) return;
+
+    std::vector<int> padded(static_cast<size_t>(width) * height, -1);
+    for (int y = 0; y < map.height; ++y) {
+        std::copy(
+            map.tiles.begin() + y * map.width, map.tiles.begin() + (y + 1) * map.width,
+            padded.begin() + y * width
+        );
+    }
+    map.width = width;
+    map.height = height;
+    map.tiles = std::move(padded);
+}
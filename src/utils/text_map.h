@@ -0,0 +1,24 @@
+#pragma once
+#include <string_view>
+#include <vector>
+
+// A plain text map: tile indices separated by whitespace or commas, one row
+// per line, -1 for empty cells. Blank lines are ignored.
+struct TextMap {
+    int width = 0;
+    int height = 0;
+    std::vector<int> tiles; // Row-major, width * height
+};
+
+// Parses a text map in one pass with std::from_chars. Width and height come
+// from the data itself; a row whose length differs from the first row, or a
+// token that isn't an integer, throws std::runtime_error naming
+// `sourceName` and the line number.
+TextMap parseTextMap(std::string_view text, const char* sourceName);
+
+// Reads the whole file in one go and parses it
+TextMap loadTextMap(const char* path);
+
+// Grows `map` to at least width x height, filling the new cells with -1
+// (empty). Maps already that big are left alone.
+void padTextMap(TextMap& map, int width, int height);
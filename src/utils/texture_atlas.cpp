@@ -0,0 +1,308 @@
+#include "texture_atlas.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm> // For std::sort, std::max, std::min
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+// Skyline bottom-left packing: the page's used area is kept as a list of
+// horizontal segments (the "skyline"), and each rectangle goes where its
+// top ends up lowest, ties broken by the narrowest fit
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height) : width(width), height(height) {
+        skyline.push_back({0, 0, width});
+    }
+
+    bool insert(int w, int h, int& outX, int& outY) {
+        int bestIndex = -1, bestY = height, bestWidth = width + 1;
+        for (size_t i = 0; i < skyline.size(); ++i) {
+            int y;
+            if (!fits(i, w, h, y)) continue;
+            if (y < bestY || (y == bestY && skyline[i].width < bestWidth)) {
+                bestIndex = static_cast<int>(i);
+                bestY = y;
+                bestWidth = skyline[i].width;
+            }
+        }
+        if (bestIndex < 0) return false;
+
+        outX = skyline[bestIndex].x;
+        outY = bestY;
+        // The new rectangle's top becomes a segment; shrink or drop the
+        // segments it now covers
+        Segment added{outX, bestY + h, w};
+        skyline.insert(skyline.begin() + bestIndex, added);
+        for (size_t i = bestIndex + 1; i < skyline.size();) {
+            Segment& s = skyline[i];
+            int coveredEnd = added.x + added.width;
+            if (s.x >= coveredEnd) break;
+            int shrink = coveredEnd - s.x;
+            if (shrink >= s.width) {
+                skyline.erase(skyline.begin() + i);
+            } else {
+                s.x += shrink;
+                s.width -= shrink;
+                break;
+            }
+        }
+        // Merge neighbours at the same height
+        for (size_t i = 0; i + 1 < skyline.size();) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            } else {
+                ++i;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Segment {
+        int x, y, width;
+    };
+    int width;
+    int height;
+    std::vector<Segment> skyline;
+
+    // Whether a w x h rectangle fits with its left edge at segment i, and
+    // how high it would have to sit
+    bool fits(size_t i, int w, int h, int& y) const {
+        int x = skyline[i].x;
+        if (x + w > width) return false;
+        y = skyline[i].y;
+        int remaining = w;
+        for (size_t j = i; remaining > 0; ++j) {
+            if (j >= skyline.size()) return false;
+            y = std::max(y, skyline[j].y);
+            if (y + h > height) return false;
+            remaining -= skyline[j].width;
+        }
+        return true;
+    }
+};
+
+const char* INDEX_HEADER = "atlas 1\n";
+
+std::string pagePath(const std::string& cachePath, int page) {
+    return cachePath + "-" + std::to_string(page) + ".png";
+}
+} // namespace
+
+TextureAtlas::Packed::Packed(Packed&& other) noexcept :
+    pages(std::move(other.pages)),
+    placements(std::move(other.placements))
+{
+    other.pages.clear();
+}
+
+TextureAtlas::Packed& TextureAtlas::Packed::operator=(Packed&& other) noexcept {
+    if (this != &other) {
+        for (SDL_Surface* page : pages) SDL_FreeSurface(page);
+        pages = std::move(other.pages);
+        placements = std::move(other.placements);
+        other.pages.clear();
+    }
+    return *this;
+}
+
+TextureAtlas::Packed::~Packed() {
+    for (SDL_Surface* page : pages) SDL_FreeSurface(page);
+}
+
+int TextureAtlas::maxPageSize(SDL_Renderer* renderer, int pageSize) {
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        if (info.max_texture_width > 0) pageSize = std::min(pageSize, info.max_texture_width);
+        if (info.max_texture_height > 0) pageSize = std::min(pageSize, info.max_texture_height);
+    }
+    return pageSize;
+}
+
+TextureAtlas::Packed TextureAtlas::pack(
+    const std::vector<std::string>& paths, const char* cachePath, int pageSize
+) {
+    Packed packed;
+    std::string sources = describeSources(paths, pageSize);
+    if (cachePath && loadCache(cachePath, sources, packed)) return packed;
+    build(paths, pageSize, packed);
+    if (cachePath) saveCache(cachePath, sources, packed);
+    return packed;
+}
+
+TextureAtlas::TextureAtlas(SDL_Renderer* renderer, Packed&& packed) {
+    Packed source = std::move(packed);
+    for (SDL_Surface* surface : source.pages) {
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (!texture) {
+            for (SDL_Texture* page : pages) SDL_DestroyTexture(page);
+            throw std::runtime_error(std::string("Failed to create atlas page: ") + SDL_GetError());
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        pages.push_back(texture);
+    }
+    for (const Placement& placement : source.placements) {
+        AtlasRegion region;
+        region.texture = pages[placement.page];
+        region.rect = placement.rect;
+        regions[placement.path] = region;
+    }
+}
+
+TextureAtlas::TextureAtlas(
+    SDL_Renderer* renderer, const std::vector<std::string>& paths,
+    const char* cachePath, int pageSize
+) :
+    TextureAtlas(renderer, pack(paths, cachePath, maxPageSize(renderer, pageSize)))
+{}
+
+TextureAtlas::~TextureAtlas() {
+    for (SDL_Texture* page : pages) {
+        SDL_DestroyTexture(page);
+    }
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& path) const {
+    auto it = regions.find(path);
+    return it != regions.end() ? &it->second : nullptr;
+}
+
+std::string TextureAtlas::describeSources(const std::vector<std::string>& paths, int pageSize) {
+    std::ostringstream out;
+    out << "page_size " << pageSize << "\n";
+    for (const std::string& path : paths) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        if (error) size = 0;
+        auto modified = std::filesystem::last_write_time(path, error);
+        long long stamp = error ? 0 : static_cast<long long>(modified.time_since_epoch().count());
+        out << "source " << size << " " << stamp << " " << path << "\n";
+    }
+    return out.str();
+}
+
+bool TextureAtlas::loadCache(const std::string& cachePath, const std::string& sources, Packed& packed) {
+    std::ifstream file(cachePath + ".idx", std::ios::binary);
+    if (!file) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string index = buffer.str();
+
+    // Stale if any source file changed since the cache was written
+    std::string expected = INDEX_HEADER + sources;
+    if (index.compare(0, expected.size(), expected) != 0) return false;
+
+    std::istringstream rest(index.substr(expected.size()));
+    std::string word;
+    int pageCount = 0;
+    if (!(rest >> word >> pageCount) || word != "pages" || pageCount < 0) return false;
+
+    Packed loaded;
+    while (rest >> word) {
+        Placement placement;
+        if (word != "region" ||
+            !(rest >> placement.page >> placement.rect.x >> placement.rect.y >>
+              placement.rect.w >> placement.rect.h) ||
+            placement.page < 0 || placement.page >= pageCount) {
+            return false;
+        }
+        rest.get(); // The space before the path
+        std::getline(rest, placement.path);
+        loaded.placements.push_back(placement);
+    }
+
+    for (int page = 0; page < pageCount; ++page) {
+        SDL_Surface* surface = IMG_Load(pagePath(cachePath, page).c_str());
+        if (!surface) return false; // `loaded` frees the pages read so far
+        loaded.pages.push_back(surface);
+    }
+    packed = std::move(loaded);
+    return true;
+}
+
+void TextureAtlas::build(const std::vector<std::string>& paths, int pageSize, Packed& packed) {
+    struct Image {
+        std::string path;
+        SDL_Surface* surface;
+    };
+    std::vector<Image> images;
+    for (const std::string& path : paths) {
+        SDL_Surface* surface = IMG_Load(path.c_str());
+        if (!surface) {
+            std::cerr << "Warning: Atlas skipping " << path << ": " << IMG_GetError() << std::endl;
+            continue;
+        }
+        if (surface->w + PADDING > pageSize || surface->h + PADDING > pageSize) {
+            std::cerr << "Warning: Atlas skipping " << path << ": larger than a page" << std::endl;
+            SDL_FreeSurface(surface);
+            continue;
+        }
+        images.push_back({path, surface});
+    }
+
+    // Tallest first packs a skyline tightest; ties by path keep it stable
+    std::sort(images.begin(), images.end(), [](const Image& a, const Image& b) {
+        if (a.surface->h != b.surface->h) return a.surface->h > b.surface->h;
+        return a.path < b.path;
+    });
+
+    std::vector<SkylinePacker> packers;
+    for (const Image& image : images) {
+        Placement placement;
+        placement.path = image.path;
+        placement.rect.w = image.surface->w;
+        placement.rect.h = image.surface->h;
+
+        // First page with room, else a new one
+        int w = image.surface->w + PADDING, h = image.surface->h + PADDING;
+        placement.page = -1;
+        for (size_t page = 0; page < packers.size(); ++page) {
+            if (packers[page].insert(w, h, placement.rect.x, placement.rect.y)) {
+                placement.page = static_cast<int>(page);
+                break;
+            }
+        }
+        if (placement.page < 0) {
+            SDL_Surface* page = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32);
+            if (!page) {
+                for (const Image& rest : images) SDL_FreeSurface(rest.surface);
+                throw std::runtime_error(std::string("Failed to create atlas page: ") + SDL_GetError());
+            }
+            packers.emplace_back(pageSize, pageSize);
+            packed.pages.push_back(page);
+            packers.back().insert(w, h, placement.rect.x, placement.rect.y);
+            placement.page = static_cast<int>(packers.size()) - 1;
+        }
+
+        // Copy pixels as they are, alpha included
+        SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+        SDL_Rect dest = placement.rect;
+        SDL_BlitSurface(image.surface, nullptr, packed.pages[placement.page], &dest);
+        packed.placements.push_back(placement);
+    }
+    for (const Image& image : images) SDL_FreeSurface(image.surface);
+}
+
+void TextureAtlas::saveCache(const std::string& cachePath, const std::string& sources, const Packed& packed) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+    for (size_t i = 0; i < packed.pages.size(); ++i) {
+        if (IMG_SavePNG(packed.pages[i], pagePath(cachePath, static_cast<int>(i)).c_str()) != 0) {
+            std::cerr << "Warning: Couldn't write atlas cache: " << IMG_GetError() << std::endl;
+            return;
+        }
+    }
+
+    // Index last, so a half-written cache is never picked up
+    std::ofstream index(cachePath + ".idx", std::ios::binary | std::ios::trunc);
+    index << INDEX_HEADER << sources << "pages " << packed.pages.size() << "\n";
+    for (const Placement& placement : packed.placements) {
+        index << "region " << placement.page << " " << placement.rect.x << " "
+              << placement.rect.y << " " << placement.rect.w << " "
+              << placement.rect.h << " " << placement.path << "\n";
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Where one source image ended up inside an atlas
+struct AtlasRegion {
+    SDL_Texture* texture = nullptr; // Atlas page, owned by the atlas
+    SDL_Rect rect{0, 0, 0, 0};      // Pixels of the source image on the page
+};
+
+// Packs many small images (sprite sheets, tilesets) into a few large
+// textures, so drawing a frame's worth of entities and tiles doesn't keep
+// switching textures and the renderer can batch the copies.
+//
+// Images are packed with a skyline bottom-left packer, tallest first. With a
+// cache path the packed pages are written as PNGs next to a small text index
+// and reused on later runs for as long as the source files are unchanged:
+//   cache/atlas.idx, cache/atlas-0.png, cache/atlas-1.png, ...
+// Images that can't be loaded or don't fit on a page are left out (with a
+// warning); find() returns null for them and callers load them as before.
+//
+// Building happens in two halves so the slow one can run off the main
+// thread: pack() decodes and packs into surfaces (any thread), then the
+// constructor uploads the pages (render thread).
+class TextureAtlas {
+public:
+    static constexpr int DEFAULT_PAGE_SIZE = 1024;
+    // Transparent pixels between images so filtering never bleeds
+    static constexpr int PADDING = 1;
+
+    struct Placement {
+        std::string path;
+        int page = 0;
+        SDL_Rect rect{0, 0, 0, 0};
+    };
+
+    // Pages in system memory and where each image went. Move-only; frees
+    // whatever surfaces it still holds.
+    struct Packed {
+        std::vector<SDL_Surface*> pages;
+        std::vector<Placement> placements;
+
+        Packed() = default;
+        Packed(Packed&& other) noexcept;
+        Packed& operator=(Packed&& other) noexcept;
+        Packed(const Packed&) = delete;
+        Packed& operator=(const Packed&) = delete;
+        ~Packed();
+    };
+
+    // Largest page the renderer can take, up to `pageSize`. Call on the
+    // render thread before handing the size to pack().
+    static int maxPageSize(SDL_Renderer* renderer, int pageSize = DEFAULT_PAGE_SIZE);
+    // Loads the cache if it's current, otherwise decodes and packs `paths`
+    // (and writes the cache). Uses no renderer, so it can run on a worker.
+    static Packed pack(const std::vector<std::string>& paths, const char* cachePath, int pageSize);
+
+    // Uploads packed pages as textures
+    TextureAtlas(SDL_Renderer* renderer, Packed&& packed);
+    // Both halves at once, on this thread
+    TextureAtlas(
+        SDL_Renderer* renderer, const std::vector<std::string>& paths,
+        const char* cachePath = nullptr, int pageSize = DEFAULT_PAGE_SIZE
+    );
+    ~TextureAtlas();
+
+    // Owns the page textures
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Region for an image by the path it was added with, or null
+    const AtlasRegion* find(const std::string& path) const;
+    int getPageCount() const { return static_cast<int>(pages.size()); }
+
+private:
+    std::vector<SDL_Texture*> pages;
+    std::unordered_map<std::string, AtlasRegion> regions;
+
+    // Fingerprint of the source files (path, size, modification time) that
+    // a cache must match to be used
+    static std::string describeSources(const std::vector<std::string>& paths, int pageSize);
+
+    static bool loadCache(const std::string& cachePath, const std::string& sources, Packed& packed);
+    static void build(const std::vector<std::string>& paths, int pageSize, Packed& packed);
+    static void saveCache(const std::string& cachePath, const std::string& sources, const Packed& packed);
+};
@@ -0,0 +1,50 @@
+#include "tile_animator.h"
+
+TileAnimator::TileAnimator(const Tileset& tileset) {
+    addAnimations(tileset.getAnimations());
+}
+
+void TileAnimator::addAnimations(const std::vector<TileAnimation>& tileAnimations, int firstId) {
+    for (const TileAnimation& source : tileAnimations) {
+        if (source.frames.empty()) continue;
+        Animation animation;
+        animation.tileId = source.tileId + firstId;
+        uint32_t end = 0;
+        for (const TileAnimationFrame& frame : source.frames) {
+            end += static_cast<uint32_t>(frame.durationMs);
+            animation.frameTiles.push_back(frame.tileId + firstId);
+            animation.frameEnds.push_back(end);
+        }
+
+        // Grow the tables to cover the new id; untouched ids map to themselves
+        if (animation.tileId >= static_cast<int>(frames.size())) {
+            size_t oldSize = frames.size();
+            frames.resize(animation.tileId + 1);
+            for (size_t id = oldSize; id < frames.size(); ++id) frames[id] = static_cast<int>(id);
+            animated.resize(frames.size(), 0);
+            changedAt.resize(frames.size(), 0);
+        }
+        animated[animation.tileId] = 1;
+        frames[animation.tileId] = animation.frameTiles[0];
+        animations.push_back(std::move(animation));
+    }
+}
+
+void TileAnimator::update(uint32_t timeMs) {
+    bool anyChanged = false;
+    for (const Animation& animation : animations) {
+        uint32_t t = timeMs % animation.frameEnds.back();
+        size_t frame = 0;
+        while (t >= animation.frameEnds[frame]) ++frame; // A handful of frames
+        int shown = animation.frameTiles[frame];
+
+        if (frames[animation.tileId] != shown) {
+            if (!anyChanged) {
+                ++tick;
+                anyChanged = true;
+            }
+            frames[animation.tileId] = shown;
+            changedAt[animation.tileId] = tick;
+        }
+    }
+}
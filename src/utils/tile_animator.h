@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "tileset.h"
+
+// Plays every animated tile from one global clock. update() works out the
+// frame each animated tile id shows right now and stores it in a
+// tile id -> displayed tile table, so every cell using that tile stays in
+// step and the per-frame cost depends on how many tiles are animated, not on
+// how many cells use them. Tilemaps read the table when drawing.
+class TileAnimator {
+public:
+    TileAnimator() = default;
+    explicit TileAnimator(const Tileset& tileset);
+
+    // Adds animations whose tile ids are offset by `firstId` (e.g.
+    // firstgid - 1 for the second tileset of a .tmx)
+    void addAnimations(const std::vector<TileAnimation>& tileAnimations, int firstId = 0);
+
+    // Moves the clock to `timeMs` (e.g. SDL_GetTicks()). Call once per frame.
+    void update(uint32_t timeMs);
+
+    // Tile to draw for `tileId` right now (tileId itself if it isn't animated)
+    int frameOf(int tileId) const {
+        return (static_cast<unsigned>(tileId) < frames.size()) ? frames[tileId] : tileId;
+    }
+    bool isAnimated(int tileId) const {
+        return static_cast<unsigned>(tileId) < animated.size() && animated[tileId];
+    }
+
+    // Bumped by every update() that changed at least one frame
+    uint32_t getTick() const { return tick; }
+    // True if the frame shown for `tileId` changed after tick `since`
+    bool changedSince(int tileId, uint32_t since) const {
+        return static_cast<unsigned>(tileId) < changedAt.size() && changedAt[tileId] > since;
+    }
+
+private:
+    struct Animation {
+        int tileId;
+        std::vector<int> frameTiles;
+        std::vector<uint32_t> frameEnds; // Cumulative end time of each frame
+    };
+
+    std::vector<Animation> animations;
+    std::vector<int> frames;          // Tile id -> tile shown
+    std::vector<uint8_t> animated;    // Tile id -> has an animation
+    std::vector<uint32_t> changedAt;  // Tile id -> tick its frame last changed
+    uint32_t tick = 0;
+};
@@ -1,78 +1,304 @@
 #include "tilemap.h"
-#include <fstream>
-#include <sstream>
 #include <stdexcept>
 #include <SDL2/SDL.h>
 #include "spritesheet.h"
 #include <iostream>
 #include <cmath> // For std::floor, std::ceil, std::abs
+#include <algorithm> // For std::min, std::max
+#include <limits>
+
+namespace {
+// Index of the lowest set bit (bits must be non-zero)
+inline int lowestBit(uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(bits);
+#else
+    int index = 0;
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+} // namespace
 
 // Constructor implementation
 Tilemap::Tilemap(
     Spritesheet* sheet, int tile_width, int tile_height, int map_width,
-    int map_height, const std::map<int, CollisionLayer>& tile_collision_layers
+    int map_height, const std::vector<CollisionLayer>& collision_lut
 ) :
     sheet(sheet),
     tile_width(tile_width),
     tile_height(tile_height),
     map_width(map_width),
     map_height(map_height),
-    tiles(map_width * map_height, -1), // Initialize vector with -1
-    tileCollisionLayers(tile_collision_layers) // Copy the layer map
+    ownedTiles(map_width * map_height, -1), // Initialize vector with -1
+    tiles(ownedTiles.data()),
+    collisionLut(collision_lut) // Copy the layer table
 {
-    if (!sheet) {
-        throw std::runtime_error("Tilemap created with null spritesheet.");
+    init();
+}
+
+// Constructor that views tile memory owned by someone else
+Tilemap::Tilemap(
+    Spritesheet* sheet, int tile_width, int tile_height, int map_width,
+    int map_height, const std::vector<CollisionLayer>& collision_lut,
+    int* tile_memory
+) :
+    sheet(sheet),
+    tile_width(tile_width),
+    tile_height(tile_height),
+    map_width(map_width),
+    map_height(map_height),
+    tiles(tile_memory),
+    collisionLut(collision_lut)
+{
+    if (!tile_memory) {
+        throw std::runtime_error("Tilemap created with null tile memory.");
     }
+    init();
+}
+
+void Tilemap::init() {
     if (tile_width <= 0 || tile_height <= 0 || map_width <= 0 ||
         map_height <= 0) {
         throw std::runtime_error("Invalid Tilemap dimensions.");
     }
+    initCollisionBits();
+
+    chunks_x = (map_width + CHUNK_TILES - 1) / CHUNK_TILES;
+    chunks_y = (map_height + CHUNK_TILES - 1) / CHUNK_TILES;
+    chunkTextures.assign(chunks_x * chunks_y, nullptr);
+    chunkDirty.assign(chunks_x * chunks_y, 1);
+    chunkAnimatedCells.assign(chunks_x * chunks_y, {});
+    chunkAnimationTick.assign(chunks_x * chunks_y, 0);
+    validateFrames();
 }
 
-// Constructor that loads from file
+// Constructor that takes over a parsed text map
 Tilemap::Tilemap(
-    Spritesheet* sheet, int tile_width, int tile_height, int map_width,
-    int map_height, const std::map<int, CollisionLayer>& tile_collision_layers,
-    const char* path
+    Spritesheet* sheet, int tile_width, int tile_height,
+    const std::vector<CollisionLayer>& collision_lut, TextMap&& text
 ) :
-    Tilemap(
-        sheet, tile_width, tile_height, map_width, map_height,
-        tile_collision_layers
-    ) // Delegate to the other constructor
+    sheet(sheet),
+    tile_width(tile_width),
+    tile_height(tile_height),
+    map_width(text.width),
+    map_height(text.height),
+    ownedTiles(std::move(text.tiles)), // No copy, the parse buffer becomes the map
+    tiles(ownedTiles.data()),
+    collisionLut(collision_lut)
 {
-    loadFromFile(path); // Load data after basic initialization
+    init();
+}
+
+Tilemap Tilemap::fromTextFile(
+    Spritesheet* sheet, int tile_width, int tile_height,
+    const std::vector<CollisionLayer>& collision_lut, const char* path
+) {
+    return Tilemap(sheet, tile_width, tile_height, collision_lut, loadTextMap(path));
 }
 
 Tilemap::~Tilemap() {
-    // No manual memory management needed for std::vector or std::map
+    // Chunk textures are the only resources we own
     // Spritesheet ownership is assumed to be external
+    destroyChunkTextures();
+    for (TilemapListener* listener : listeners) {
+        listener->onTilemapDestroyed(*this);
+    }
+}
+
+void Tilemap::addListener(TilemapListener* listener) const {
+    if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void Tilemap::removeListener(TilemapListener* listener) const {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+void Tilemap::flushChanges() {
+    if (dirtyRegions.empty()) return;
+    // Listeners may edit the map in response; those edits go in the next batch
+    std::vector<TileRect> regions;
+    regions.swap(dirtyRegions);
+    for (TilemapListener* listener : listeners) {
+        listener->onTilesChanged(*this, regions);
+    }
+}
+
+// Adds a region to the pending list, merging it with an existing one when
+// their bounding box wastes no area (overlapping or edge-adjacent strips,
+// e.g. a column destroyed a tile at a time). Past MAX_DIRTY_REGIONS
+// everything collapses into one bounding box.
+void Tilemap::addDirtyRegion(TileRect region) {
+    auto area = [](const TileRect& r) { return static_cast<long long>(r.w) * r.h; };
+    auto bounds = [](const TileRect& a, const TileRect& b) {
+        int x0 = std::min(a.x, b.x);
+        int y0 = std::min(a.y, b.y);
+        int x1 = std::max(a.x + a.w, b.x + b.w);
+        int y1 = std::max(a.y + a.h, b.y + b.h);
+        return TileRect{x0, y0, x1 - x0, y1 - y0};
+    };
+
+    // Merging can make the result mergeable with another region, so repeat
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < dirtyRegions.size(); ++i) {
+            TileRect combined = bounds(dirtyRegions[i], region);
+            if (area(combined) <= area(dirtyRegions[i]) + area(region)) {
+                region = combined;
+                dirtyRegions.erase(dirtyRegions.begin() + i);
+                merged = true;
+                break;
+            }
+        }
+    }
+    dirtyRegions.push_back(region);
+
+    if (dirtyRegions.size() > MAX_DIRTY_REGIONS) {
+        TileRect all = dirtyRegions[0];
+        for (const TileRect& r : dirtyRegions) all = bounds(all, r);
+        dirtyRegions.assign(1, all);
+    }
 }
 
 // Set tile data at given tile coordinates
 void Tilemap::setTile(int tileX, int tileY, int tile_index) {
-    if (tileX >= 0 && tileX < map_width && tileY >= 0 && tileY < map_height) {
-        tiles[tileY * map_width + tileX] = tile_index;
+    writeRegion({tileX, tileY, 1, 1}, nullptr, 0, tile_index);
+}
+
+void Tilemap::setTiles(const TileRect& region, int tile_index) {
+    writeRegion(region, nullptr, 0, tile_index);
+}
+
+void Tilemap::setTiles(const TileRect& region, const int* source, int stride) {
+    if (!source) return;
+    writeRegion(region, source, (stride > 0) ? stride : region.w, -1);
+}
+
+// Shared by setTile/setTiles. Only the part of the region inside the window
+// is written; collision bits, block summaries, chunk flags and the dirty
+// list are all updated for the tiles that actually changed.
+void Tilemap::writeRegion(const TileRect& region, const int* source, int stride, int fill) {
+    int x0 = std::max(region.x - origin_x, 0);
+    int y0 = std::max(region.y, 0);
+    int x1 = std::min(region.x + region.w - origin_x, map_width);
+    int y1 = std::min(region.y + region.h, map_height);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    // Bounds of what really changed, in local coordinates
+    int changedX0 = x1, changedY0 = y1, changedX1 = x0, changedY1 = y0;
+    bool lostLayers = false; // Some block may need its summary rebuilt
+    bool layersChanged = false; // Distance fields need updating
+
+    for (int y = y0; y < y1; ++y) {
+        int* row = tiles + y * map_width;
+        // Source column of local column x is x + sourceShift
+        const int* sourceRow = source ? source + (y - region.y) * stride : nullptr;
+        const int sourceShift = origin_x - region.x;
+        uint32_t* blockRow = blockLayers.data() + (y / COLLISION_BLOCK) * blocks_x;
+        for (int x = x0; x < x1; ++x) {
+            int tile_index = sourceRow ? sourceRow[x + sourceShift] : fill;
+            if (row[x] == tile_index) continue;
+
+            uint32_t oldBits = static_cast<uint32_t>(layerOfTile(row[x]));
+            uint32_t newBits = static_cast<uint32_t>(layerOfTile(tile_index));
+            row[x] = tile_index;
+            if (oldBits != newBits) {
+                setCollisionBits(x, y, oldBits, newBits);
+                blockRow[x / COLLISION_BLOCK] |= newBits;
+                lostLayers = lostLayers || (oldBits & ~newBits) != 0;
+                layersChanged = true;
+            }
+
+            changedX0 = std::min(changedX0, x);
+            changedX1 = std::max(changedX1, x + 1);
+            changedY0 = std::min(changedY0, y);
+            changedY1 = std::max(changedY1, y + 1);
+        }
+    }
+    if (changedX0 >= changedX1) return; // Nothing changed
+
+    ++revision;
+    if (lostLayers) {
+        rebuildBlocks(changedX0, changedY0, changedX1, changedY1);
     }
+    if (layersChanged) {
+        for (auto& field : distanceFields) {
+            field->update(changedX0, changedY0, changedX1, changedY1);
+        }
+    }
+    for (int cy = changedY0 / CHUNK_TILES; cy <= (changedY1 - 1) / CHUNK_TILES; ++cy) {
+        for (int cx = changedX0 / CHUNK_TILES; cx <= (changedX1 - 1) / CHUNK_TILES; ++cx) {
+            chunkDirty[cy * chunks_x + cx] = 1;
+        }
+    }
+    addDirtyRegion({
+        changedX0 + origin_x, changedY0, changedX1 - changedX0, changedY1 - changedY0
+    });
 }
 
 // Get tile index at given tile coordinates
 int Tilemap::getTile(int tileX, int tileY) const {
-    if (tileX >= 0 && tileX < map_width && tileY >= 0 && tileY < map_height) {
-        return tiles[tileY * map_width + tileX];
+    int localX = tileX - origin_x;
+    if (localX >= 0 && localX < map_width && tileY >= 0 && tileY < map_height) {
+        return tiles[tileY * map_width + localX];
     }
     return -1; // Out of bounds or empty
 }
 
+// Slides the window right by whole chunks. Columns that fall off the left
+// are dropped, new columns on the right start empty.
+void Tilemap::scrollWindow(int chunks) {
+    if (chunks <= 0) return;
+    int columns = chunks * CHUNK_TILES;
+    origin_x += columns;
+    ++revision;
+
+    int keep = std::max(0, map_width - columns);
+    for (int y = 0; y < map_height; ++y) {
+        int* row = tiles + y * map_width;
+        std::copy(row + (map_width - keep), row + map_width, row);
+        std::fill(row + keep, row + map_width, -1);
+    }
+    initCollisionBits();
+    for (auto& field : distanceFields) field->rebuild();
+    // Every cell of the window now holds a different column
+    addDirtyRegion({origin_x, 0, map_width, map_height});
+
+    // A partial last chunk has a smaller texture, so it can't be reused in
+    // another slot; just re-render everything in that case
+    if (map_width % CHUNK_TILES != 0) {
+        destroyChunkTextures();
+        return;
+    }
+
+    // Surviving chunk textures move left, freed ones are reused on the right
+    int shift = std::min(chunks, chunks_x);
+    for (int cy = 0; cy < chunks_y; ++cy) {
+        auto rowStart = chunkTextures.begin() + cy * chunks_x;
+        std::rotate(rowStart, rowStart + shift, rowStart + chunks_x);
+        auto dirtyStart = chunkDirty.begin() + cy * chunks_x;
+        std::rotate(dirtyStart, dirtyStart + shift, dirtyStart + chunks_x);
+        std::fill(dirtyStart + (chunks_x - shift), dirtyStart + chunks_x, 1);
+        auto cellsStart = chunkAnimatedCells.begin() + cy * chunks_x;
+        std::rotate(cellsStart, cellsStart + shift, cellsStart + chunks_x);
+        auto tickStart = chunkAnimationTick.begin() + cy * chunks_x;
+        std::rotate(tickStart, tickStart + shift, tickStart + chunks_x);
+    }
+}
+
 // Get collision layer of a tile at given coordinates
 CollisionLayer Tilemap::getTileLayer(int tileX, int tileY) const {
-     int tileIndex = getTile(tileX, tileY);
-     if (tileIndex != -1) {
-         auto it = tileCollisionLayers.find(tileIndex);
-         if (it != tileCollisionLayers.end()) {
-             return it->second; // Return the layer from the map
-         }
-     }
-     return CollisionLayer::NONE; // No specific layer defined for this tile
+    int localX = tileX - origin_x;
+    if (localX < 0 || localX >= map_width || tileY < 0 || tileY >= map_height) {
+        return CollisionLayer::LEVEL_BOUNDARY;
+    }
+    return localLayer(localX, tileY);
 }
 
 
@@ -80,98 +306,482 @@ CollisionLayer Tilemap::getTileLayer(int tileX, int tileY) const {
 void Tilemap::draw(
     SDL_Renderer* renderer, int dest_x, int dest_y, int dest_w, int dest_h
 ) const {
+    if (!sheet) return; // Collision-only map
+
     int drawTileW = (dest_w == -1) ? tile_width : dest_w;
     int drawTileH = (dest_h == -1) ? tile_height : dest_h;
 
-    for (int y = 0; y < map_height; ++y) {
-        for (int x = 0; x < map_width; ++x) {
-            int tile_index = getTile(x, y);
-            if (tile_index != -1) { // Only draw valid tiles
-                int drawPosX = dest_x + x * drawTileW;
-                int drawPosY = dest_y + y * drawTileH;
-
-                try {
-                    sheet->select_sprite(tile_index);
-                    sheet->draw(renderer, drawPosX, drawPosY, drawTileW, drawTileH);
-                } catch (const std::out_of_range& oor) {
-                     std::cerr << "Tilemap draw error: Tile index " << tile_index
-                               << " out of range for spritesheet." << std::endl;
-                     // Optionally draw an error tile or skip
+    if (!SDL_RenderTargetSupported(renderer)) {
+        drawTiles(renderer, 0, 0, map_width, map_height, dest_x + origin_x * drawTileW, dest_y, drawTileW, drawTileH);
+        return;
+    }
+
+    // Textures belong to one renderer
+    if (chunkRenderer != renderer) {
+        destroyChunkTextures();
+        chunkRenderer = renderer;
+    }
+
+    // dest_x is where world x = 0 goes; the window starts origin_x tiles in
+    dest_x += origin_x * drawTileW;
+
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer, &viewport);
+    int chunkW = CHUNK_TILES * drawTileW;
+    int chunkH = CHUNK_TILES * drawTileH;
+
+    // Only visit chunks that overlap the viewport
+    int cx0 = std::max(0, static_cast<int>(std::floor(-dest_x / static_cast<float>(chunkW))));
+    int cy0 = std::max(0, static_cast<int>(std::floor(-dest_y / static_cast<float>(chunkH))));
+    int cx1 = std::min(chunks_x - 1, static_cast<int>(std::floor((viewport.w - dest_x) / static_cast<float>(chunkW))));
+    int cy1 = std::min(chunks_y - 1, static_cast<int>(std::floor((viewport.h - dest_y) / static_cast<float>(chunkH))));
+
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            int index = cy * chunks_x + cx;
+            if (chunkDirty[index] || !chunkTextures[index]) {
+                renderChunk(renderer, cx, cy);
+            } else if (animator && !chunkAnimatedCells[index].empty() &&
+                       chunkAnimationTick[index] != animator->getTick()) {
+                refreshAnimatedCells(renderer, cx, cy);
+            }
+            if (!chunkTextures[index]) continue; // Couldn't create it
+
+            int tilesW = std::min(CHUNK_TILES, map_width - cx * CHUNK_TILES);
+            int tilesH = std::min(CHUNK_TILES, map_height - cy * CHUNK_TILES);
+            SDL_Rect destRect = {
+                dest_x + cx * chunkW, dest_y + cy * chunkH,
+                tilesW * drawTileW, tilesH * drawTileH
+            };
+            SDL_RenderCopy(renderer, chunkTextures[index], NULL, &destRect);
+        }
+    }
+}
+
+void Tilemap::invalidateRenderCache() {
+    destroyChunkTextures();
+}
+
+void Tilemap::setCollisionLut(const std::vector<CollisionLayer>& collision_lut) {
+    collisionLut = collision_lut;
+    initCollisionBits();
+    for (auto& field : distanceFields) field->rebuild();
+    ++revision;
+    addDirtyRegion({origin_x, 0, map_width, map_height});
+}
+
+void Tilemap::setAnimator(const TileAnimator* newAnimator) {
+    animator = newAnimator;
+    std::fill(chunkDirty.begin(), chunkDirty.end(), 1); // Rebuild cell lists
+}
+
+void Tilemap::destroyChunkTextures() const {
+    for (SDL_Texture*& texture : chunkTextures) {
+        if (texture) {
+            SDL_DestroyTexture(texture);
+            texture = nullptr;
+        }
+    }
+    std::fill(chunkDirty.begin(), chunkDirty.end(), 1);
+}
+
+// Re-renders one chunk into its texture at native tile size
+void Tilemap::renderChunk(SDL_Renderer* renderer, int chunkX, int chunkY) const {
+    int index = chunkY * chunks_x + chunkX;
+    int x0 = chunkX * CHUNK_TILES;
+    int y0 = chunkY * CHUNK_TILES;
+    int x1 = std::min(x0 + CHUNK_TILES, map_width);
+    int y1 = std::min(y0 + CHUNK_TILES, map_height);
+
+    if (!chunkTextures[index]) {
+        chunkTextures[index] = SDL_CreateTexture(
+            renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+            (x1 - x0) * tile_width, (y1 - y0) * tile_height
+        );
+        if (!chunkTextures[index]) {
+            std::cerr << "Failed to create tilemap chunk texture: "
+                      << SDL_GetError() << std::endl;
+            return;
+        }
+        SDL_SetTextureBlendMode(chunkTextures[index], SDL_BLENDMODE_BLEND);
+    }
+
+    // Render into the chunk, then put the renderer back how we found it
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
+    SDL_SetRenderTarget(renderer, chunkTextures[index]);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0); // Empty tiles stay transparent
+    SDL_RenderClear(renderer);
+    drawTiles(
+        renderer, x0, y0, x1, y1, -x0 * tile_width, -y0 * tile_height,
+        tile_width, tile_height
+    );
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    chunkDirty[index] = 0;
+
+    // Remember where the animated cells are so later frames can redraw
+    // just those
+    std::vector<uint16_t>& cells = chunkAnimatedCells[index];
+    cells.clear();
+    if (animator) {
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                if (animator->isAnimated(tiles[y * map_width + x])) {
+                    cells.push_back(static_cast<uint16_t>((y - y0) * CHUNK_TILES + (x - x0)));
                 }
             }
         }
+        chunkAnimationTick[index] = animator->getTick();
     }
 }
 
-// Load map data from a text file
-void Tilemap::loadFromFile(const char* path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        throw std::runtime_error(
-            std::string("Failed to open tilemap file: ") + path
+void Tilemap::refreshAnimatedCells(SDL_Renderer* renderer, int chunkX, int chunkY) const {
+    int index = chunkY * chunks_x + chunkX;
+    int x0 = chunkX * CHUNK_TILES;
+    int y0 = chunkY * CHUNK_TILES;
+    uint32_t drawnTick = chunkAnimationTick[index];
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_BlendMode previousBlend;
+    SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+
+    SDL_SetRenderTarget(renderer, chunkTextures[index]);
+    // Overwrite (not blend) so the old frame is wiped to transparent
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    for (uint16_t cell : chunkAnimatedCells[index]) {
+        int x = x0 + cell % CHUNK_TILES;
+        int y = y0 + cell / CHUNK_TILES;
+        if (!animator->changedSince(tiles[y * map_width + x], drawnTick)) continue;
+
+        SDL_Rect cellRect = {
+            (x - x0) * tile_width, (y - y0) * tile_height, tile_width, tile_height
+        };
+        SDL_RenderFillRect(renderer, &cellRect);
+        drawTiles(
+            renderer, x, y, x + 1, y + 1, -x0 * tile_width, -y0 * tile_height,
+            tile_width, tile_height
         );
     }
 
-    std::string line;
-    int y = 0;
-    while (std::getline(file, line) && y < map_height) {
-        std::stringstream ss(line);
-        int x = 0;
-        int tile_index;
-        while (ss >> tile_index && x < map_width) {
-            setTile(x, y, tile_index);
-            x++;
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    chunkAnimationTick[index] = animator->getTick();
+}
+
+void Tilemap::drawTiles(
+    SDL_Renderer* renderer, int x0, int y0, int x1, int y1, int originX,
+    int originY, int drawTileW, int drawTileH
+) const {
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            int tile_index = tiles[y * map_width + x];
+            if (animator) tile_index = animator->frameOf(tile_index);
+            // Empty cells (-1) and ids the sheet has no frame for (reported
+            // once by validateFrames) draw nothing
+            if (sheet->isValidFrame(tile_index)) {
+                SDL_Rect dest{originX + x * drawTileW, originY + y * drawTileH, drawTileW, drawTileH};
+                sheet->draw(renderer, tile_index, dest);
+            }
         }
-        y++;
     }
+}
 
-    if (y < map_height) {
-         std::cerr << "Warning: Tilemap file " << path << " has fewer rows (" << y
-                   << ") than expected (" << map_height << ")." << std::endl;
+void Tilemap::validateFrames() const {
+    if (!sheet) return;
+    int invalid = 0, example = -1;
+    for (int i = 0; i < map_width * map_height; ++i) {
+        if (tiles[i] != -1 && !sheet->isValidFrame(tiles[i])) {
+            if (invalid++ == 0) example = tiles[i];
+        }
+    }
+    if (invalid > 0) {
+        std::cerr << "Warning: " << invalid << " map tiles (e.g. " << example
+                  << ") have no frame in the " << sheet->getFrameCount()
+                  << "-frame spritesheet and won't be drawn." << std::endl;
     }
+}
+
+// (Re)builds the bitmaps for the layer bits the LUT actually uses from the
+// current tile data
+void Tilemap::initCollisionBits() {
+    uint32_t usedBits = 0;
+    for (CollisionLayer layer : collisionLut) {
+        usedBits |= static_cast<uint32_t>(layer);
+    }
+
+    bitmap_words = (map_width + 63) / 64;
+    for (int bit = 0; bit < LAYER_BITS; ++bit) {
+        if (usedBits & (1u << bit)) {
+            layerBits[bit].assign(bitmap_words * map_height, 0);
+        } else {
+            layerBits[bit].clear();
+        }
+    }
+
+    blocks_x = (map_width + COLLISION_BLOCK - 1) / COLLISION_BLOCK;
+    int blocks_y = (map_height + COLLISION_BLOCK - 1) / COLLISION_BLOCK;
+    blockLayers.assign(blocks_x * blocks_y, 0);
 
-    file.close();
+    // Fill in whatever tiles are already there
+    for (int y = 0; y < map_height; ++y) {
+        uint32_t* blockRow = blockLayers.data() + (y / COLLISION_BLOCK) * blocks_x;
+        for (int x = 0; x < map_width; ++x) {
+            uint32_t bits = static_cast<uint32_t>(localLayer(x, y));
+            if (bits) {
+                setCollisionBits(x, y, 0, bits);
+                blockRow[x / COLLISION_BLOCK] |= bits;
+            }
+        }
+    }
 }
 
-// Internal helper to check if a specific tile index collides with a given mask
-bool Tilemap::isTileCollidable(int tileIndex, CollisionLayer entityMask) const {
-    if (tileIndex == -1) return false; // Empty tile
+// Keeps the layer bitmaps in sync with a single cell change
+void Tilemap::setCollisionBits(int localX, int tileY, uint32_t oldBits, uint32_t newBits) {
+    size_t word = tileY * bitmap_words + localX / 64;
+    uint64_t bit = 1ull << (localX % 64);
+    for (uint32_t changed = oldBits ^ newBits; changed; changed &= changed - 1) {
+        int b = lowestBit(changed);
+        if (layerBits[b].empty()) continue;
+        if (newBits & (1u << b)) {
+            layerBits[b][word] |= bit;
+        } else {
+            layerBits[b][word] &= ~bit;
+        }
+    }
+}
 
-    auto it = tileCollisionLayers.find(tileIndex);
-    if (it != tileCollisionLayers.end()) {
-        // Check if the tile's layer interacts with the entity's mask
-        return ::checkCollision(entityMask, it->second);
+// Layers were removed somewhere in [x0, x1) x [y0, y1); recompute the
+// summaries of the blocks it touches from the tiles
+void Tilemap::rebuildBlocks(int x0, int y0, int x1, int y1) {
+    for (int by = y0 / COLLISION_BLOCK; by <= (y1 - 1) / COLLISION_BLOCK; ++by) {
+        for (int bx = x0 / COLLISION_BLOCK; bx <= (x1 - 1) / COLLISION_BLOCK; ++bx) {
+            uint32_t block = 0;
+            int cellX1 = std::min((bx + 1) * COLLISION_BLOCK, map_width);
+            int cellY1 = std::min((by + 1) * COLLISION_BLOCK, map_height);
+            for (int y = by * COLLISION_BLOCK; y < cellY1; ++y) {
+                for (int x = bx * COLLISION_BLOCK; x < cellX1; ++x) {
+                    block |= static_cast<uint32_t>(localLayer(x, y));
+                }
+            }
+            blockLayers[by * blocks_x + bx] = block;
+        }
     }
-    return false; // Tile index not found in collision map, assume non-collidable
 }
 
 // New collision check function
 bool Tilemap::checkCollision(const SDL_FRect& boundingBox, CollisionLayer entityMask) const {
+    return queryLayers(boundingBox, entityMask) != CollisionLayer::NONE;
+}
+
+CollisionLayer Tilemap::queryLayers(const SDL_FRect& boundingBox, CollisionLayer mask) const {
     // Convert world coordinates (boundingBox) to tile coordinates
     // Note: Assumes boundingBox x,y is top-left. Adjust if it's center.
-    int startTileX = static_cast<int>(std::floor(boundingBox.x / tile_width));
-    int endTileX = static_cast<int>(std::floor((boundingBox.x + boundingBox.w) / tile_width));
+    // (columns relative to the window)
+    // The box is half-open ([x, x + w)), as in sweepBox, so a box resting
+    // exactly against a wall or the map's edge isn't touching it and
+    // whatever sweepBox stops flush against doesn't count as a collision.
+    int startTileX = static_cast<int>(std::floor(boundingBox.x / tile_width)) - origin_x;
+    int endTileX = static_cast<int>(std::ceil((boundingBox.x + boundingBox.w) / tile_width)) - 1 - origin_x;
     int startTileY = static_cast<int>(std::floor(boundingBox.y / tile_height));
-    int endTileY = static_cast<int>(std::floor((boundingBox.y + boundingBox.h) / tile_height));
+    int endTileY = static_cast<int>(std::ceil((boundingBox.y + boundingBox.h) / tile_height)) - 1;
+
+    // Off the map is LEVEL_BOUNDARY
+    const float mapLeft = static_cast<float>(origin_x * tile_width);
+    const float mapRight = static_cast<float>((origin_x + map_width) * tile_width);
+    const float mapBottom = static_cast<float>(map_height * tile_height);
+    uint32_t found = 0;
+    if (boundingBox.x < mapLeft || boundingBox.y < 0.0f ||
+        boundingBox.x + boundingBox.w > mapRight || boundingBox.y + boundingBox.h > mapBottom) {
+        found = static_cast<uint32_t>(mask) & static_cast<uint32_t>(CollisionLayer::LEVEL_BOUNDARY);
+    }
 
-    // Clamp tile coordinates to map bounds
+    // Clamp tile coordinates to map bounds for the tiles themselves
     startTileX = std::max(0, startTileX);
     endTileX = std::min(map_width - 1, endTileX);
     startTileY = std::max(0, startTileY);
     endTileY = std::min(map_height - 1, endTileY);
+    if (startTileX > endTileX || startTileY > endTileY) {
+        return static_cast<CollisionLayer>(found); // Entirely off the map
+    }
+
+    // Coarse pass: which of the wanted layers exist anywhere nearby?
+    uint32_t candidates = 0;
+    for (int by = startTileY / COLLISION_BLOCK; by <= endTileY / COLLISION_BLOCK; ++by) {
+        for (int bx = startTileX / COLLISION_BLOCK; bx <= endTileX / COLLISION_BLOCK; ++bx) {
+            candidates |= blockLayers[by * blocks_x + bx];
+        }
+    }
+    candidates &= static_cast<uint32_t>(mask);
+    if (candidates == 0) {
+        return static_cast<CollisionLayer>(found);
+    }
+
+    // Fine pass: AND each row's span against the layer bitmaps
+    int firstWord = startTileX / 64;
+    int lastWord = endTileX / 64;
+    uint64_t firstMask = ~0ull << (startTileX % 64);
+    uint64_t lastMask = ~0ull >> (63 - endTileX % 64);
+
+    for (uint32_t pending = candidates; pending; pending &= pending - 1) {
+        int b = lowestBit(pending);
+        const std::vector<uint64_t>& bits = layerBits[b];
+        bool hit = false;
+        for (int ty = startTileY; ty <= endTileY && !hit; ++ty) {
+            const uint64_t* row = bits.data() + ty * bitmap_words;
+            for (int w = firstWord; w <= lastWord; ++w) {
+                uint64_t span = ~0ull;
+                if (w == firstWord) span &= firstMask;
+                if (w == lastWord) span &= lastMask;
+                if (row[w] & span) {
+                    hit = true;
+                    break;
+                }
+            }
+        }
+        if (hit) found |= 1u << b;
+    }
+
+    return static_cast<CollisionLayer>(found);
+}
+
 
-    // Check all tiles the bounding box overlaps
-    for (int ty = startTileY; ty <= endTileY; ++ty) {
-        for (int tx = startTileX; tx <= endTileX; ++tx) {
-            int tileIndex = getTile(tx, ty);
-            if (isTileCollidable(tileIndex, entityMask)) {
-                // Found a collision with a relevant tile layer
-                return true;
+const DistanceField& Tilemap::getDistanceField(CollisionLayer mask) const {
+    for (const auto& field : distanceFields) {
+        if (field->getMask() == mask) return *field;
+    }
+    distanceFields.push_back(std::make_unique<DistanceField>(*this, mask));
+    return *distanceFields.back();
+}
+
+// Swept AABB vs grid. The box is treated as half-open ([x, x + w)), so a box
+// resting exactly against a wall is not considered to be touching it.
+SweepHit Tilemap::sweepBox(
+    const SDL_FRect& boundingBox, float dx, float dy, CollisionLayer entityMask
+) const {
+    const float inf = std::numeric_limits<float>::infinity();
+    SweepHit result;
+
+    auto firstTile = [](float lo, float size) {
+        return static_cast<int>(std::floor(lo / size));
+    };
+    auto lastTile = [](float hi, float size) {
+        return static_cast<int>(std::ceil(hi / size)) - 1;
+    };
+
+    // Checks a run of cells; stores the first solid one in result
+    auto testCells = [&](int x0, int x1, int y0, int y1, float t, float nx, float ny) {
+        for (int ty = y0; ty <= y1; ++ty) {
+            for (int tx = x0; tx <= x1; ++tx) {
+                CollisionLayer layer = getTileLayer(tx, ty);
+                if (::checkCollision(entityMask, layer)) {
+                    result.hit = true;
+                    result.time = t;
+                    result.normalX = nx;
+                    result.normalY = ny;
+                    result.tileX = tx;
+                    result.tileY = ty;
+                    result.layer = layer;
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    const float bx = boundingBox.x;
+    const float by = boundingBox.y;
+    const float bw = boundingBox.w;
+    const float bh = boundingBox.h;
+
+    // Already overlapping something?
+    if (testCells(
+            firstTile(bx, tile_width), lastTile(bx + bw, tile_width),
+            firstTile(by, tile_height), lastTile(by + bh, tile_height), 0.0f,
+            0.0f, 0.0f
+        )) {
+        return result;
+    }
+
+    // Next column/row the leading edges will enter, and when
+    int stepX = (dx > 0) ? 1 : -1;
+    int stepY = (dy > 0) ? 1 : -1;
+    int nextCol = (dx > 0) ? lastTile(bx + bw, tile_width) + 1 : firstTile(bx, tile_width) - 1;
+    int nextRow = (dy > 0) ? lastTile(by + bh, tile_height) + 1 : firstTile(by, tile_height) - 1;
+    float tNextX = inf, tNextY = inf;
+    float tDeltaX = inf, tDeltaY = inf;
+    if (dx != 0.0f) {
+        float edge = (dx > 0) ? bx + bw : bx;
+        float boundary = (dx > 0) ? nextCol * tile_width : (nextCol + 1) * tile_width;
+        tNextX = (boundary - edge) / dx;
+        tDeltaX = tile_width / std::abs(dx);
+    }
+    if (dy != 0.0f) {
+        float edge = (dy > 0) ? by + bh : by;
+        float boundary = (dy > 0) ? nextRow * tile_height : (nextRow + 1) * tile_height;
+        tNextY = (boundary - edge) / dy;
+        tDeltaY = tile_height / std::abs(dy);
+    }
+
+    while (true) {
+        float t = std::min(tNextX, tNextY);
+        if (t > 1.0f) break; // Move finishes before the next crossing
+
+        float x = bx + dx * t;
+        float y = by + dy * t;
+        if (tNextX == tNextY) {
+            // Exactly through a corner: the new column, the new row and the
+            // cell diagonal to the box are all entered at once. The half-open
+            // box ranges exclude that diagonal cell, so test it explicitly.
+            if (testCells(
+                    nextCol, nextCol, firstTile(y, tile_height),
+                    lastTile(y + bh, tile_height), t, -static_cast<float>(stepX), 0.0f
+                ) ||
+                testCells(
+                    firstTile(x, tile_width), lastTile(x + bw, tile_width),
+                    nextRow, nextRow, t, 0.0f, -static_cast<float>(stepY)
+                ) ||
+                testCells(
+                    nextCol, nextCol, nextRow, nextRow, t,
+                    -static_cast<float>(stepX), -static_cast<float>(stepY)
+                )) {
+                return result;
+            }
+            nextCol += stepX;
+            tNextX += tDeltaX;
+            nextRow += stepY;
+            tNextY += tDeltaY;
+        } else if (tNextX < tNextY) {
+            // Entering a new column: test it across the box's current rows
+            if (testCells(
+                    nextCol, nextCol, firstTile(y, tile_height),
+                    lastTile(y + bh, tile_height), t, -static_cast<float>(stepX), 0.0f
+                )) {
+                return result;
+            }
+            nextCol += stepX;
+            tNextX += tDeltaX;
+        } else {
+            // Entering a new row: test it across the box's current columns
+            if (testCells(
+                    firstTile(x, tile_width), lastTile(x + bw, tile_width),
+                    nextRow, nextRow, t, 0.0f, -static_cast<float>(stepY)
+                )) {
+                return result;
             }
+            nextRow += stepY;
+            tNextY += tDeltaY;
         }
     }
 
-    return false; // No collision found
+    return result; // No hit, full move allowed
 }
 
 
@@ -189,86 +799,172 @@ Direction Tilemap::intersects_rect(float x, float y, float w, float h) const {
 }
 */
 
-// Raycast function - might need updating to consider layers
-float Tilemap::raycast(float x, float y, float angle) const {
-    // Convert start position to tile space (assuming x,y is center)
-    float startTileX = x / tile_width;
-    float startTileY = y / tile_height;
-
-    float rayDirX = std::cos(angle);
-    float rayDirY = std::sin(angle);
-
-    // Current tile coordinates
-    int mapX = static_cast<int>(startTileX);
-    int mapY = static_cast<int>(startTileY);
-
-    // Length of ray from current position to next x or y-side
-    float sideDistX, sideDistY;
-
-    // Length of ray from one x or y-side to next x or y-side
-    float deltaDistX = (rayDirX == 0) ? 1e30f : std::abs(1.0f / rayDirX);
-    float deltaDistY = (rayDirY == 0) ? 1e30f : std::abs(1.0f / rayDirY);
-    float perpWallDist;
-
-    // Which direction to step in x or y-direction (either +1 or -1)
-    int stepX, stepY;
-
-    bool hit = false; // Was there a wall hit?
-    int side;         // Was a NS or a EW wall hit?
-
-    // Calculate step and initial sideDist
-    if (rayDirX < 0) {
-        stepX = -1;
-        sideDistX = (startTileX - mapX) * deltaDistX;
-    } else {
-        stepX = 1;
-        sideDistX = (mapX + 1.0f - startTileX) * deltaDistX;
-    }
-    if (rayDirY < 0) {
-        stepY = -1;
-        sideDistY = (startTileY - mapY) * deltaDistY;
-    } else {
-        stepY = 1;
-        sideDistY = (mapY + 1.0f - startTileY) * deltaDistY;
-    }
-
-    // Perform DDA (Digital Differential Analysis)
-    while (!hit) {
-        // Jump to next map square, OR in x-direction, OR in y-direction
-        if (sideDistX < sideDistY) {
-            sideDistX += deltaDistX;
-            mapX += stepX;
-            side = 0; // Hit vertical wall line
-        } else {
-            sideDistY += deltaDistY;
-            mapY += stepY;
-            side = 1; // Hit horizontal wall line
+// Raycast functions
+RaycastHit Tilemap::raycast(
+    float x, float y, float angle, CollisionLayer mask, float maxDistance
+) const {
+    float dirX = std::cos(angle);
+    float dirY = std::sin(angle);
+    RaycastHit hit;
+    castRays(x, y, &dirX, &dirY, 1, mask, maxDistance, &hit);
+    return hit;
+}
+
+void Tilemap::raycastFan(
+    float x, float y, float centerAngle, float spread, int count,
+    CollisionLayer mask, float maxDistance, std::vector<RaycastHit>& hits
+) const {
+    hits.assign(std::max(count, 0), RaycastHit{});
+    if (count <= 0) return;
+
+    float startAngle = (count == 1) ? centerAngle : centerAngle - spread / 2.0f;
+    float angleStep = (count == 1) ? 0.0f : spread / (count - 1);
+
+    float dirX[RAY_BATCH];
+    float dirY[RAY_BATCH];
+    for (int base = 0; base < count; base += RAY_BATCH) {
+        int n = std::min(RAY_BATCH, count - base);
+        for (int i = 0; i < n; ++i) {
+            float angle = startAngle + angleStep * (base + i);
+            dirX[i] = std::cos(angle);
+            dirY[i] = std::sin(angle);
         }
+        castRays(x, y, dirX, dirY, n, mask, maxDistance, &hits[base]);
+    }
+}
 
-        // Check if ray is outside map bounds
-        if (mapX < 0 || mapX >= map_width || mapY < 0 || mapY >= map_height) {
-            return -1.0f; // Hit map boundary (or went to infinity)
+// DDA (Digital Differential Analysis) over up to RAY_BATCH rays at once.
+// Per-ray state is kept in parallel arrays and every active ray advances one
+// grid line per pass, so the stepping arithmetic is straight-line code over
+// contiguous floats. Distances are measured along the (unit) ray in world
+// units, which keeps them correct for non-square tiles.
+void Tilemap::castRays(
+    float worldX, float y, const float* dirX, const float* dirY, int count,
+    CollisionLayer mask, float maxDistance, RaycastHit* hits
+) const {
+    // Work relative to the left edge of the window
+    const float x = worldX - static_cast<float>(origin_x * tile_width);
+    const float inf = std::numeric_limits<float>::infinity();
+    const float worldW = static_cast<float>(map_width * tile_width);
+    const float worldH = static_cast<float>(map_height * tile_height);
+    const bool boundaryStops = ::checkCollision(mask, CollisionLayer::LEVEL_BOUNDARY);
+    const bool originInside = x >= 0 && x < worldW && y >= 0 && y < worldH;
+
+    int mapX[RAY_BATCH], mapY[RAY_BATCH];
+    int stepX[RAY_BATCH], stepY[RAY_BATCH];
+    float sideX[RAY_BATCH], sideY[RAY_BATCH];
+    float deltaX[RAY_BATCH], deltaY[RAY_BATCH];
+    bool active[RAY_BATCH];
+    int activeCount = 0;
+
+    auto finish = [&](int i, bool didHit, float t, int tx, int ty, float nx,
+                      float ny, CollisionLayer layer) {
+        RaycastHit& h = hits[i];
+        h.hit = didHit;
+        h.distance = t;
+        h.x = worldX + dirX[i] * t;
+        h.y = y + dirY[i] * t;
+        h.tileX = didHit ? tx + origin_x : -1;
+        h.tileY = ty;
+        h.normalX = nx;
+        h.normalY = ny;
+        h.layer = layer;
+        active[i] = false;
+    };
+
+    // Set up each ray, clipping it to the map rectangle first
+    for (int i = 0; i < count; ++i) {
+        active[i] = false;
+        float invX = (dirX[i] == 0.0f) ? inf : 1.0f / dirX[i];
+        float invY = (dirY[i] == 0.0f) ? inf : 1.0f / dirY[i];
+
+        if (!originInside && boundaryStops) {
+            // Already outside the playfield
+            finish(i, true, 0.0f, static_cast<int>(std::floor(x / tile_width)),
+                   static_cast<int>(std::floor(y / tile_height)), 0.0f, 0.0f,
+                   CollisionLayer::LEVEL_BOUNDARY);
+            continue;
         }
 
-        // Check if ray has hit a collidable tile
-        // *** TODO: Update this check to use isTileCollidable with an appropriate mask ***
-        // For now, just checks if the tile exists in the collision layer map
-        int hitTileIndex = getTile(mapX, mapY);
-        if (hitTileIndex != -1 && tileCollisionLayers.count(hitTileIndex)) {
-             // Assuming any tile in the map is collidable for raycast for now
-             // A proper implementation would pass the entity's mask
-             // if (isTileCollidable(hitTileIndex, MASK_RAYCAST_TARGETS)) { hit = true; }
-             hit = true;
+        // Slab test against the map bounds
+        float tx0 = (0.0f - x) * invX, tx1 = (worldW - x) * invX;
+        float ty0 = (0.0f - y) * invY, ty1 = (worldH - y) * invY;
+        if (dirX[i] == 0.0f) { tx0 = (x >= 0 && x < worldW) ? -inf : inf; tx1 = -tx0; }
+        if (dirY[i] == 0.0f) { ty0 = (y >= 0 && y < worldH) ? -inf : inf; ty1 = -ty0; }
+        float tEnter = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), 0.0f);
+        float tExit = std::min(std::max(tx0, tx1), std::max(ty0, ty1));
+        if (tEnter > tExit || tEnter > maxDistance) {
+            finish(i, false, maxDistance, -1, -1, 0.0f, 0.0f, CollisionLayer::NONE);
+            continue;
+        }
+
+        // Entry tile, clamped so rays starting on the far edge stay in range
+        float ex = x + dirX[i] * tEnter;
+        float ey = y + dirY[i] * tEnter;
+        mapX[i] = std::min(std::max(static_cast<int>(std::floor(ex / tile_width)), 0), map_width - 1);
+        mapY[i] = std::min(std::max(static_cast<int>(std::floor(ey / tile_height)), 0), map_height - 1);
+
+        stepX[i] = (dirX[i] < 0) ? -1 : 1;
+        stepY[i] = (dirY[i] < 0) ? -1 : 1;
+        deltaX[i] = std::abs(tile_width * invX);
+        deltaY[i] = std::abs(tile_height * invY);
+        float nextX = (dirX[i] < 0) ? mapX[i] * tile_width : (mapX[i] + 1) * tile_width;
+        float nextY = (dirY[i] < 0) ? mapY[i] * tile_height : (mapY[i] + 1) * tile_height;
+        sideX[i] = (dirX[i] == 0.0f) ? inf : (nextX - x) * invX;
+        sideY[i] = (dirY[i] == 0.0f) ? inf : (nextY - y) * invY;
+
+        // The entry tile itself may already be solid
+        CollisionLayer entryLayer = localLayer(mapX[i], mapY[i]);
+        if (::checkCollision(mask, entryLayer)) {
+            float nx = 0.0f, ny = 0.0f;
+            if (tEnter > 0.0f) { // Came in through a map edge
+                if (std::min(tx0, tx1) >= std::min(ty0, ty1)) nx = -static_cast<float>(stepX[i]);
+                else ny = -static_cast<float>(stepY[i]);
+            }
+            finish(i, true, tEnter, mapX[i], mapY[i], nx, ny, entryLayer);
+            continue;
         }
-    }
 
-    // Calculate distance projected on camera direction (Euclidean distance would be sqrt(distSq))
-    if (side == 0) {
-        perpWallDist = (sideDistX - deltaDistX);
-    } else {
-        perpWallDist = (sideDistY - deltaDistY);
+        active[i] = true;
+        ++activeCount;
     }
 
-    // Convert distance back to world space
-    return perpWallDist * tile_width; // Assumes square tiles for simplicity
+    // Step all live rays one grid line per pass
+    while (activeCount > 0) {
+        for (int i = 0; i < count; ++i) {
+            if (!active[i]) continue;
+
+            bool alongX = sideX[i] < sideY[i];
+            float t = alongX ? sideX[i] : sideY[i];
+            sideX[i] += alongX ? deltaX[i] : 0.0f;
+            sideY[i] += alongX ? 0.0f : deltaY[i];
+            mapX[i] += alongX ? stepX[i] : 0;
+            mapY[i] += alongX ? 0 : stepY[i];
+            float nx = alongX ? -static_cast<float>(stepX[i]) : 0.0f;
+            float ny = alongX ? 0.0f : -static_cast<float>(stepY[i]);
+
+            if (t > maxDistance) {
+                finish(i, false, maxDistance, -1, -1, 0.0f, 0.0f, CollisionLayer::NONE);
+                --activeCount;
+                continue;
+            }
+
+            if (mapX[i] < 0 || mapX[i] >= map_width || mapY[i] < 0 ||
+                mapY[i] >= map_height) {
+                if (boundaryStops) {
+                    finish(i, true, t, mapX[i], mapY[i], nx, ny, CollisionLayer::LEVEL_BOUNDARY);
+                } else {
+                    finish(i, false, t, -1, -1, 0.0f, 0.0f, CollisionLayer::NONE);
+                }
+                --activeCount;
+                continue;
+            }
+
+            CollisionLayer tileLayer = localLayer(mapX[i], mapY[i]);
+            if (::checkCollision(mask, tileLayer)) {
+                finish(i, true, t, mapX[i], mapY[i], nx, ny, tileLayer);
+                --activeCount;
+            }
+        }
+    }
 }
@@ -1,45 +1,210 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include <memory>
 #include <vector>
-#include <map> // For mapping tile index to layer
 #include "spritesheet.h"
+#include "text_map.h"
+#include "tile_animator.h"
+#include "distance_field.h"
 #include "collisions_defs.h" // Include collision definitions
 #include "direction.h"       // Keep for now if needed elsewhere
 
+// Result of a Tilemap raycast
+struct RaycastHit {
+    bool hit = false;     // False if the ray ran out of length first
+    float x = 0.0f;       // World-space point where the ray stopped
+    float y = 0.0f;
+    int tileX = -1;       // Tile that was hit (may be just outside the map
+    int tileY = -1;       // for LEVEL_BOUNDARY hits)
+    float normalX = 0.0f; // Face normal of the hit side, (0, 0) if the ray
+    float normalY = 0.0f; // started inside a solid tile
+    CollisionLayer layer = CollisionLayer::NONE; // Layer of the hit tile
+    float distance = 0.0f; // Euclidean distance travelled in world units
+};
+
+// Result of sweeping a box through the tile grid
+struct SweepHit {
+    bool hit = false;
+    float time = 1.0f;    // Fraction of the move completed before contact
+    float normalX = 0.0f; // Normal of the face that was hit (both axes for an
+    float normalY = 0.0f; // exact corner), (0, 0) if the box already overlapped
+    int tileX = -1;
+    int tileY = -1;
+    CollisionLayer layer = CollisionLayer::NONE;
+};
+
+// Rectangle of tiles in world tile coordinates
+struct TileRect {
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+};
+
+class Tilemap;
+
+// Something that caches data derived from a Tilemap's tiles. Registered
+// listeners get one coalesced batch of changed regions per frame from
+// Tilemap::flushChanges(), so they can rebuild just those areas.
+class TilemapListener {
+public:
+    virtual ~TilemapListener() = default;
+    // `regions` are in world tile coordinates and may overlap; together they
+    // cover every tile that changed since the last flush
+    virtual void onTilesChanged(const Tilemap& map, const std::vector<TileRect>& regions) = 0;
+    // The map is going away; drop any pointer to it
+    virtual void onTilemapDestroyed(const Tilemap& map) = 0;
+};
+
+// Every collision query treats space outside the map (or outside the
+// current window, for streamed levels) as LEVEL_BOUNDARY: getTileLayer,
+// checkCollision/queryLayers, sweepBox, raycast and the distance fields all
+// agree, so anything an entity can stand in, its projectiles can fly through.
 class Tilemap {
 public:
-    // Constructor now takes a map defining which tile indices map to which collision layers
+    // Constructor takes a dense table giving the collision layer of each tile
+    // index (usually Tileset::getCollisionLut()). Indices past the end of the
+    // table have no collision. `sheet` may be null for a collision-only map,
+    // which is never drawn and needs no textures.
     Tilemap(
         Spritesheet* sheet, int tile_width, int tile_height, int map_width,
-        int map_height, const std::map<int, CollisionLayer>& tile_collision_layers
+        int map_height, const std::vector<CollisionLayer>& collision_lut
     );
-    // Constructor to load from file (will need to parse layer info or use defaults)
+    // Loads a text map (see text_map.h), sized to whatever the file holds.
+    // Throws std::runtime_error if the file is missing or malformed.
+    static Tilemap fromTextFile(
+        Spritesheet* sheet, int tile_width, int tile_height,
+        const std::vector<CollisionLayer>& collision_lut, const char* path
+    );
+    // Constructor viewing existing tile memory (map_width * map_height ints,
+    // row-major) instead of allocating its own, e.g. a layer of a
+    // memory-mapped LevelFile. The memory must outlive the map; setTile
+    // writes to it.
     Tilemap(
         Spritesheet* sheet, int tile_width, int tile_height, int map_width,
-        int map_height, const std::map<int, CollisionLayer>& tile_collision_layers,
-        const char* path
+        int map_height, const std::vector<CollisionLayer>& collision_lut,
+        int* tile_memory
     );
     ~Tilemap();
 
+    // Owns GPU textures for its chunk cache, so it can't be copied
+    Tilemap(const Tilemap&) = delete;
+    Tilemap& operator=(const Tilemap&) = delete;
+
+    // Tile coordinates are world tile coordinates: column 0 is world x = 0,
+    // wherever the window currently is (see scrollWindow)
     void setTile(int tileX, int tileY, int tile_index);
+    // Batched edits. Collision data and render chunks are updated for just
+    // the region, so cost scales with the region rather than the map.
+    // Fills `region` with one tile:
+    void setTiles(const TileRect& region, int tile_index);
+    // Copies region.w x region.h tiles from `source`, whose rows are `stride`
+    // ints apart (0 means region.w):
+    void setTiles(const TileRect& region, const int* source, int stride = 0);
     int getTile(int tileX, int tileY) const;
-    CollisionLayer getTileLayer(int tileX, int tileY) const; // Get layer of a tile
+    CollisionLayer getTileLayer(int tileX, int tileY) const; // Get layer of a tile (LEVEL_BOUNDARY off the map)
+    // Replaces the tile -> layer table and rebuilds the collision data
+    void setCollisionLut(const std::vector<CollisionLayer>& collision_lut);
+
+    int getTileWidth() const { return tile_width; }
+    int getTileHeight() const { return tile_height; }
+    int getMapWidth() const { return map_width; }
+    // First world column held by the map (non-zero once it has scrolled)
+    int getOriginX() const { return origin_x; }
+    int getMapHeight() const { return map_height; }
+    // Bumped every time tile data changes, so caches built on top of the
+    // map (e.g. VisibilityService) know when to throw their results away
+    uint32_t getRevision() const { return revision; }
 
+    // Draws the map with its top-left corner at (dest_x, dest_y); dest_w and
+    // dest_h override the on-screen size of a tile. The map is pre-rendered
+    // into CHUNK_TILES x CHUNK_TILES textures on first use and a chunk is only
+    // re-rendered after setTile changes it, so a frame costs one copy per
+    // visible chunk. Falls back to per-tile drawing without render targets.
     void draw(
         SDL_Renderer* renderer, int dest_x, int dest_y, int dest_w = -1,
         int dest_h = -1
     ) const;
 
+    // Size of a render/streaming chunk in tiles
+    static constexpr int CHUNK_TILES = 32;
+
+    // The map is a fixed-size window onto a possibly much longer level.
+    // Scrolling moves the window right by whole chunks: the leftmost columns
+    // are discarded and the new columns on the right start empty (-1), ready
+    // to be filled in (see LevelStreamer). Memory use stays constant.
+    void scrollWindow(int chunks);
+
+    // Warns about tiles the spritesheet has no frame for. Drawing skips
+    // them silently, so this is the one place bad indices get reported; the
+    // constructors call it, and so should code that bulk-loads tiles later.
+    void validateFrames() const;
+
+    // Drops all cached chunk textures, e.g. on SDL_RENDER_TARGETS_RESET
+    void invalidateRenderCache();
+
+    // Draws animated tiles with the animator's current frames (null turns
+    // animation off). Cached chunks stay cached: each chunk keeps a list of
+    // its animated cells and only those are redrawn into the chunk's texture
+    // when their frame changes. Not owned.
+    void setAnimator(const TileAnimator* animator);
+
+    // Listeners are told about tile changes in flushChanges(). Not owned.
+    // Registering doesn't change the map, so it works through const maps.
+    void addListener(TilemapListener* listener) const;
+    void removeListener(TilemapListener* listener) const;
+    // Delivers the regions changed since the last call to every listener,
+    // merged into as few rectangles as is cheap. Call once per frame.
+    void flushChanges();
+
     // New collision check function using layers and masks
     // Takes a proposed bounding box and the entity's collision mask
     // Returns true if a collision occurs with a relevant tile layer.
     bool checkCollision(const SDL_FRect& boundingBox, CollisionLayer entityMask) const;
 
+    // Union of every tile layer the box overlaps, limited to `mask` bits.
+    // A box reaching past the map's edges also overlaps LEVEL_BOUNDARY.
+    // Boxes are half-open, as in sweepBox: touching a tile isn't overlapping.
+    // One call answers wall and hazard checks together, e.g.
+    //   CollisionLayer hit = map->queryLayers(box, entity->mask);
+    //   if (hit & CollisionLayer::LEVEL_HAZARD_LAVA) ...
+    CollisionLayer queryLayers(
+        const SDL_FRect& boundingBox,
+        CollisionLayer mask = static_cast<CollisionLayer>(~0u)
+    ) const;
+
+    // Continuous collision: moves `boundingBox` by (dx, dy) and reports the
+    // first tile it would touch. Only the tiles the box's leading edges cross
+    // are visited, so fast movers can't tunnel through thin walls and cost
+    // scales with distance travelled in tiles. Outside the map counts as
+    // LEVEL_BOUNDARY.
+    SweepHit sweepBox(
+        const SDL_FRect& boundingBox, float dx, float dy, CollisionLayer entityMask
+    ) const;
+
+    // Distance to the nearest tile that collides with `mask`. Built the first
+    // time a mask is asked for, then kept current by every edit (only the
+    // neighbourhood of changed tiles is recomputed), so sampling it is O(1).
+    //   if (map->getDistanceField(mask).clearance(x, y) > moveLength) ...
+    const DistanceField& getDistanceField(CollisionLayer mask) const;
+
     // Old intersects_rect - Deprecated or adapt if needed
     // Direction intersects_rect(float x, float y, float w, float h) const;
 
-    // Raycast might need updating to consider layers too
-    float raycast(float x, float y, float angle) const;
+    // Casts a ray from (x, y) in world space. Tiles whose layer intersects
+    // `mask` stop the ray. Leaving the map counts as hitting a
+    // LEVEL_BOUNDARY tile if the mask includes it.
+    RaycastHit raycast(
+        float x, float y, float angle, CollisionLayer mask, float maxDistance
+    ) const;
+
+    // Casts `count` rays spread evenly over `spread` radians centered on
+    // `centerAngle` (sight cones, shotgun patterns). All rays are walked
+    // together, so this is much cheaper than `count` raycast() calls.
+    void raycastFan(
+        float x, float y, float centerAngle, float spread, int count,
+        CollisionLayer mask, float maxDistance, std::vector<RaycastHit>& hits
+    ) const;
 
 private:
     Spritesheet* sheet;
@@ -47,14 +212,88 @@ private:
     int tile_height;
     int map_width;
     int map_height;
-    std::vector<int> tiles; // Use std::vector for easier management
-    std::map<int, CollisionLayer> tileCollisionLayers; // Map tile index -> layer
+    std::vector<int> ownedTiles; // Empty when viewing external memory
+    int* tiles;                  // ownedTiles.data() or the external memory
+    std::vector<CollisionLayer> collisionLut; // Tile index -> layer
+    uint32_t revision = 0;
+    int origin_x = 0; // World column of tiles[0]
+
+    // Changed regions waiting for flushChanges(), in world tile coordinates
+    static constexpr size_t MAX_DIRTY_REGIONS = 8;
+    std::vector<TileRect> dirtyRegions;
+    mutable std::vector<TilemapListener*> listeners;
+    void addDirtyRegion(TileRect region);
+
+    // Packed collision bitmaps, one per CollisionLayer bit that any tile in
+    // the LUT uses (others stay empty). Rows are padded to whole 64-bit
+    // words so a box test is a few masked ANDs per row.
+    static constexpr int LAYER_BITS = 32;
+    int bitmap_words = 0; // Words per row
+    std::vector<uint64_t> layerBits[LAYER_BITS];
+    // Coarse summary: OR of the layers of every tile in each
+    // COLLISION_BLOCK x COLLISION_BLOCK block, for rejecting empty areas
+    static constexpr int COLLISION_BLOCK = 8;
+    int blocks_x = 0;
+    std::vector<uint32_t> blockLayers;
+
+    // One per mask asked for through getDistanceField()
+    mutable std::vector<std::unique_ptr<DistanceField>> distanceFields;
 
-    // Helper to load map data from a text file
-    void loadFromFile(const char* path);
-    // Helper to save map data (optional)
-    // void saveToFile(const char* path) const;
+    // Pre-rendered chunks, created lazily by draw()
+    int chunks_x = 0;
+    int chunks_y = 0;
+    mutable std::vector<SDL_Texture*> chunkTextures;
+    mutable std::vector<uint8_t> chunkDirty;
+    mutable SDL_Renderer* chunkRenderer = nullptr;
 
-    // Internal helper to check if a specific tile index has a collision layer
-    bool isTileCollidable(int tileIndex, CollisionLayer entityMask) const;
+    // Animated cells of each chunk, as offsets y * CHUNK_TILES + x inside
+    // the chunk (so they survive scrolling), rebuilt with the chunk
+    const TileAnimator* animator = nullptr;
+    mutable std::vector<std::vector<uint16_t>> chunkAnimatedCells;
+    mutable std::vector<uint32_t> chunkAnimationTick; // Animator tick drawn
+
+    void destroyChunkTextures() const;
+    void renderChunk(SDL_Renderer* renderer, int chunkX, int chunkY) const;
+    // Redraws the chunk's animated cells whose frame changed since it was
+    // last drawn
+    void refreshAnimatedCells(SDL_Renderer* renderer, int chunkX, int chunkY) const;
+    // Draws tiles [x0, x1) x [y0, y1) with tile (0, 0) at (originX, originY)
+    void drawTiles(
+        SDL_Renderer* renderer, int x0, int y0, int x1, int y1, int originX,
+        int originY, int drawTileW, int drawTileH
+    ) const;
+
+    void init(); // Shared constructor setup once tiles is set
+    void initCollisionBits();
+    // Sets/clears one cell's bits in the layer bitmaps (not the block summary)
+    void setCollisionBits(int localX, int tileY, uint32_t oldBits, uint32_t newBits);
+    // Recomputes the block summary for blocks overlapping a local rectangle
+    void rebuildBlocks(int x0, int y0, int x1, int y1);
+    // Writes a clipped region; `source` null means fill with `fill`
+    void writeRegion(const TileRect& region, const int* source, int stride, int fill);
+
+    // Takes over a parsed text map's tiles (see fromTextFile)
+    Tilemap(
+        Spritesheet* sheet, int tile_width, int tile_height,
+        const std::vector<CollisionLayer>& collision_lut, TextMap&& text
+    );
+
+    // Layer of a tile index via the flat lookup table (-1 is NONE)
+    CollisionLayer layerOfTile(int tileIndex) const {
+        return (static_cast<unsigned>(tileIndex) < collisionLut.size())
+                   ? collisionLut[tileIndex]
+                   : CollisionLayer::NONE;
+    }
+
+    // Layer of an in-range cell, in window-relative coordinates
+    CollisionLayer localLayer(int localX, int localY) const {
+        return layerOfTile(tiles[localY * map_width + localX]);
+    }
+
+    // Walks up to RAY_BATCH rays from the same origin in lockstep
+    static constexpr int RAY_BATCH = 16;
+    void castRays(
+        float x, float y, const float* dirX, const float* dirY, int count,
+        CollisionLayer mask, float maxDistance, RaycastHit* hits
+    ) const;
 };
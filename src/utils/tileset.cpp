@@ -0,0 +1,124 @@
+#include "tileset.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <iostream>
+#include "asset_path.h"
+#include "xml_reader.h"
+
+bool parseCollisionLayers(std::string_view names, CollisionLayer& out) {
+    static const struct {
+        const char* name;
+        CollisionLayer layer;
+    } known[] = {
+        {"floor", CollisionLayer::LEVEL_FLOOR},
+        {"wall", CollisionLayer::LEVEL_WALL},
+        {"obstacle", CollisionLayer::LEVEL_OBSTACLE},
+        {"boundary", CollisionLayer::LEVEL_BOUNDARY},
+        {"pit", CollisionLayer::LEVEL_PIT},
+        {"lava", CollisionLayer::LEVEL_HAZARD_LAVA},
+        {"toxin", CollisionLayer::LEVEL_HAZARD_TOXIN},
+        {"solid", CollisionLayer::LAYER_WALL},
+    };
+
+    out = CollisionLayer::NONE;
+    bool ok = true;
+    while (!names.empty()) {
+        size_t comma = names.find(',');
+        std::string_view token = names.substr(0, comma);
+        names = (comma == std::string_view::npos) ? std::string_view() : names.substr(comma + 1);
+
+        // Trim whitespace
+        while (!token.empty() && token.front() == ' ') token.remove_prefix(1);
+        while (!token.empty() && token.back() == ' ') token.remove_suffix(1);
+        if (token.empty()) continue;
+
+        bool found = false;
+        for (const auto& entry : known) {
+            if (token == entry.name) {
+                out |= entry.layer;
+                found = true;
+                break;
+            }
+        }
+        ok = ok && found;
+    }
+    return ok;
+}
+
+Tileset::Tileset(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("Failed to open tileset file: ") + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string document = buffer.str();
+
+    // Image paths in .tsx files are relative to the tileset itself
+    parse(document, directoryOf(path), path);
+}
+
+Tileset::Tileset(std::string_view document, const std::string& directory) {
+    parse(document, directory, "<embedded>");
+}
+
+void Tileset::parse(
+    std::string_view document, const std::string& directory, const char* sourceName
+) {
+    XmlReader xml(document);
+    int currentTile = -1;
+    while (xml.next()) {
+        std::string_view tag = xml.name();
+        if (tag == "tileset" && !xml.isClosing()) {
+            name = std::string(xml.attribute("name"));
+            tile_width = xml.intAttribute("tilewidth");
+            tile_height = xml.intAttribute("tileheight");
+            tile_count = xml.intAttribute("tilecount");
+            columns = xml.intAttribute("columns");
+        } else if (tag == "image" && !xml.isClosing()) {
+            image_path = resolveAssetPath(directory, xml.attribute("source"));
+        } else if (tag == "tile") {
+            currentTile = xml.isClosing() ? -1 : xml.intAttribute("id", -1);
+            if (xml.isSelfClosing()) currentTile = -1;
+        } else if (tag == "property" && currentTile >= 0 &&
+                   xml.attribute("name") == "collision") {
+            CollisionLayer layer;
+            if (!parseCollisionLayers(xml.attribute("value"), layer)) {
+                std::cerr << "Warning: Tileset " << sourceName << " tile " << currentTile
+                          << " has unknown collision layer in \""
+                          << xml.attribute("value") << "\"." << std::endl;
+            }
+            if (currentTile >= static_cast<int>(collision_lut.size())) {
+                collision_lut.resize(currentTile + 1, CollisionLayer::NONE);
+            }
+            collision_lut[currentTile] = layer;
+        } else if (tag == "animation" && currentTile >= 0) {
+            if (!xml.isClosing()) {
+                if (!xml.isSelfClosing()) animations.push_back({currentTile, {}});
+            } else if (!animations.empty() && animations.back().frames.empty()) {
+                animations.pop_back(); // Nothing to play
+            }
+        } else if (tag == "frame" && currentTile >= 0 && !animations.empty() &&
+                   animations.back().tileId == currentTile) {
+            TileAnimationFrame frame;
+            frame.tileId = xml.intAttribute("tileid", -1);
+            frame.durationMs = xml.intAttribute("duration");
+            if (frame.tileId < 0 || frame.durationMs <= 0) {
+                std::cerr << "Warning: Tileset " << sourceName << " tile " << currentTile
+                          << " has an invalid animation frame, skipping it." << std::endl;
+                continue;
+            }
+            animations.back().frames.push_back(frame);
+        }
+    }
+
+    if (tile_width <= 0 || tile_height <= 0) {
+        throw std::runtime_error(std::string("Invalid tileset dimensions in: ") + sourceName);
+    }
+
+    // Every tile in the set gets an entry, collidable or not
+    if (static_cast<int>(collision_lut.size()) < tile_count) {
+        collision_lut.resize(tile_count, CollisionLayer::NONE);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "collisions_defs.h"
+
+// One frame of an animated tile
+struct TileAnimationFrame {
+    int tileId = 0;      // Local tile id shown during this frame
+    int durationMs = 0;
+};
+
+// A Tiled <animation>: tile `tileId` cycles through `frames`
+struct TileAnimation {
+    int tileId = 0;
+    std::vector<TileAnimationFrame> frames;
+};
+
+// Tile metadata read from a Tiled tileset (.tsx).
+// Collision data comes from a custom "collision" string property on each
+// tile, holding one or more layer names separated by commas, e.g.
+//   <tile id="3"><properties>
+//     <property name="collision" value="wall,boundary"/>
+//   </properties></tile>
+// Recognised names: floor, wall, obstacle, boundary, pit, lava, toxin and
+// solid (wall + obstacle + boundary).
+// Animated tiles (<animation> in Tiled) are listed by getAnimations(); see
+// TileAnimator for playing them back.
+class Tileset {
+public:
+    explicit Tileset(const char* path);
+    // Parses a <tileset> element that is already in memory (e.g. embedded in
+    // a .tmx). `directory` is what relative image paths are resolved against.
+    Tileset(std::string_view document, const std::string& directory);
+
+    const std::string& getName() const { return name; }
+    int getTileWidth() const { return tile_width; }
+    int getTileHeight() const { return tile_height; }
+    int getTileCount() const { return tile_count; }
+    int getColumns() const { return columns; }
+    // Image path resolved relative to the .tsx file
+    const std::string& getImagePath() const { return image_path; }
+
+    // Dense table indexed by local tile id, ready to hand to a Tilemap
+    const std::vector<CollisionLayer>& getCollisionLut() const { return collision_lut; }
+    const std::vector<TileAnimation>& getAnimations() const { return animations; }
+
+private:
+    std::string name;
+    int tile_width = 0;
+    int tile_height = 0;
+    int tile_count = 0;
+    int columns = 0;
+    std::string image_path;
+    std::vector<CollisionLayer> collision_lut;
+    std::vector<TileAnimation> animations;
+
+    void parse(std::string_view document, const std::string& directory, const char* sourceName);
+};
+
+// Parses a comma-separated list of layer names (see Tileset).
+// Returns false if any name is unknown.
+bool parseCollisionLayers(std::string_view names, CollisionLayer& out);
@@ -0,0 +1,261 @@
+#include "tmx_map.h"
+#include <algorithm> // For std::copy
+#include <charconv>
+#include <cstring>   // For std::memcpy
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <zlib.h>
+#include "asset_path.h"
+#include "xml_reader.h"
+
+namespace {
+// High bits of a global tile id that Tiled uses for flipping
+constexpr uint32_t GID_FLIP_HORIZONTAL = 0x80000000u;
+constexpr uint32_t GID_FLIP_VERTICAL = 0x40000000u;
+constexpr uint32_t GID_FLIP_DIAGONAL = 0x20000000u;
+constexpr uint32_t GID_ROTATED_HEX = 0x10000000u; // Hex maps only, ignored
+constexpr uint32_t GID_FLAGS =
+    GID_FLIP_HORIZONTAL | GID_FLIP_VERTICAL | GID_FLIP_DIAGONAL | GID_ROTATED_HEX;
+
+std::string readFile(const char* path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("Failed to open map file: ") + path);
+    }
+    std::string contents(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(contents.data(), contents.size());
+    return contents;
+}
+
+// Splits a gid into its tile id and flip bits and stores it in the layer
+void storeGid(TmxLayer& layer, size_t index, uint32_t gid) {
+    uint8_t flips = TILE_FLIP_NONE;
+    if (gid & GID_FLIP_HORIZONTAL) flips |= TILE_FLIP_HORIZONTAL;
+    if (gid & GID_FLIP_VERTICAL) flips |= TILE_FLIP_VERTICAL;
+    if (gid & GID_FLIP_DIAGONAL) flips |= TILE_FLIP_DIAGONAL;
+    gid &= ~GID_FLAGS;
+    layer.tiles[index] = (gid == 0) ? -1 : static_cast<int>(gid - 1);
+    layer.flips[index] = flips;
+}
+
+void decodeCsv(std::string_view text, TmxLayer& layer) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    size_t count = 0;
+    while (count < layer.tiles.size()) {
+        while (p < end && (*p < '0' || *p > '9')) ++p; // Commas, newlines
+        if (p >= end) break;
+        uint32_t gid = 0;
+        auto result = std::from_chars(p, end, gid);
+        if (result.ec != std::errc()) {
+            throw std::runtime_error("Invalid CSV tile data in layer '" + layer.name + "'");
+        }
+        storeGid(layer, count++, gid);
+        p = result.ptr;
+    }
+    if (count < layer.tiles.size()) {
+        std::cerr << "Layer '" << layer.name << "' has " << count << " of "
+                  << layer.tiles.size() << " tiles, the rest are left empty" << std::endl;
+    }
+}
+
+std::vector<uint8_t> decodeBase64(std::string_view text) {
+    // 0-63 for the alphabet, 64 for padding/whitespace, 255 for invalid
+    static const auto table = [] {
+        struct Table { uint8_t value[256]; } t;
+        std::memset(t.value, 255, sizeof(t.value));
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i) t.value[static_cast<uint8_t>(alphabet[i])] = i;
+        for (char c : {'=', ' ', '\t', '\n', '\r'}) t.value[static_cast<uint8_t>(c)] = 64;
+        return t;
+    }();
+
+    std::vector<uint8_t> bytes;
+    bytes.reserve(text.size() / 4 * 3);
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (char c : text) {
+        uint8_t value = table.value[static_cast<uint8_t>(c)];
+        if (value == 64) continue;
+        if (value == 255) throw std::runtime_error("Invalid base64 tile data");
+        bits = (bits << 6) | value;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            bytes.push_back(static_cast<uint8_t>(bits >> bitCount));
+        }
+    }
+    return bytes;
+}
+
+// Inflates zlib or gzip data into exactly `size` bytes
+std::vector<uint8_t> inflateData(const std::vector<uint8_t>& compressed, size_t size) {
+    std::vector<uint8_t> out(size);
+    z_stream stream{};
+    // 15 window bits, +32 to detect the zlib or gzip header automatically
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        throw std::runtime_error("Failed to initialise zlib");
+    }
+    stream.next_in = const_cast<Bytef*>(compressed.data());
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<uInt>(out.size());
+    int status = inflate(&stream, Z_FINISH);
+    size_t produced = out.size() - stream.avail_out;
+    inflateEnd(&stream);
+    if (status != Z_STREAM_END && status != Z_BUF_ERROR) {
+        throw std::runtime_error("Corrupt compressed tile data");
+    }
+    out.resize(produced);
+    return out;
+}
+
+void decodeBase64Layer(std::string_view text, std::string_view compression, TmxLayer& layer) {
+    std::vector<uint8_t> bytes = decodeBase64(text);
+    if (compression == "zlib" || compression == "gzip") {
+        bytes = inflateData(bytes, layer.tiles.size() * 4);
+    } else if (!compression.empty()) {
+        throw std::runtime_error(
+            "Unsupported compression '" + std::string(compression) + "' in layer '" + layer.name + "'"
+        );
+    }
+
+    // Gids are little-endian 32-bit values
+    size_t count = std::min(bytes.size() / 4, layer.tiles.size());
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* b = &bytes[i * 4];
+        uint32_t gid = b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+        storeGid(layer, i, gid);
+    }
+    if (count < layer.tiles.size()) {
+        std::cerr << "Layer '" << layer.name << "' has " << count << " of "
+                  << layer.tiles.size() << " tiles, the rest are left empty" << std::endl;
+    }
+}
+} // namespace
+
+TmxMap::TmxMap(const char* path) {
+    const std::string document = readFile(path);
+
+    // Tileset sources are relative to the map file
+    const std::string directory = directoryOf(path);
+
+    XmlReader xml(document);
+    TmxLayer* layer = nullptr;   // Tile layer being read
+    size_t xmlTileIndex = 0;     // Next cell for <tile> children of <data>
+    bool inXmlData = false;
+    std::string group;           // Name of the object layer being read
+
+    while (xml.next()) {
+        std::string_view tag = xml.name();
+
+        if (tag == "map" && !xml.isClosing()) {
+            if (xml.attribute("infinite") == "1") {
+                throw std::runtime_error(std::string("Infinite maps are not supported: ") + path);
+            }
+            width = xml.intAttribute("width");
+            height = xml.intAttribute("height");
+            tile_width = xml.intAttribute("tilewidth");
+            tile_height = xml.intAttribute("tileheight");
+            if (width <= 0 || height <= 0) {
+                throw std::runtime_error(std::string("Invalid map dimensions in ") + path);
+            }
+        } else if (tag == "tileset" && !xml.isClosing()) {
+            int firstGid = xml.intAttribute("firstgid", 1);
+            std::string_view source = xml.attribute("source");
+            if (!source.empty()) {
+                std::string tsxPath = resolveAssetPath(directory, source);
+                tilesets.push_back({firstGid, Tileset(tsxPath.c_str())});
+                xml.skipElement();
+            } else {
+                tilesets.push_back({firstGid, Tileset(xml.elementSource(), directory)});
+            }
+        } else if (tag == "layer") {
+            if (xml.isClosing()) {
+                layer = nullptr;
+                continue;
+            }
+            TmxLayer& added = layers.emplace_back();
+            added.name = std::string(xml.attribute("name"));
+            added.visible = xml.intAttribute("visible", 1) != 0;
+            added.opacity = xml.floatAttribute("opacity", 1.0f);
+            added.width = xml.intAttribute("width", width);
+            added.height = xml.intAttribute("height", height);
+            added.tiles.assign(static_cast<size_t>(added.width) * added.height, -1);
+            added.flips.assign(added.tiles.size(), TILE_FLIP_NONE);
+            layer = xml.isSelfClosing() ? nullptr : &added;
+        } else if (tag == "data" && layer) {
+            if (xml.isClosing()) {
+                inXmlData = false;
+                continue;
+            }
+            std::string_view encoding = xml.attribute("encoding");
+            if (encoding == "csv") {
+                decodeCsv(xml.text(), *layer);
+            } else if (encoding == "base64") {
+                decodeBase64Layer(xml.text(), xml.attribute("compression"), *layer);
+            } else if (encoding.empty()) {
+                inXmlData = !xml.isSelfClosing();
+                xmlTileIndex = 0;
+            } else {
+                throw std::runtime_error(
+                    "Unsupported encoding '" + std::string(encoding) + "' in layer '" + layer->name + "'"
+                );
+            }
+        } else if (tag == "chunk") {
+            throw std::runtime_error(std::string("Infinite maps are not supported: ") + path);
+        } else if (tag == "tile" && inXmlData && !xml.isClosing()) {
+            if (xmlTileIndex < layer->tiles.size()) {
+                uint32_t gid = 0;
+                std::string_view value = xml.attribute("gid");
+                std::from_chars(value.data(), value.data() + value.size(), gid);
+                storeGid(*layer, xmlTileIndex++, gid);
+            }
+        } else if (tag == "objectgroup") {
+            group = xml.isClosing() ? std::string() : std::string(xml.attribute("name"));
+        } else if (tag == "object" && !xml.isClosing()) {
+            SpawnPoint& spawn = spawns.emplace_back();
+            spawn.name = std::string(xml.attribute("name"));
+            spawn.type = std::string(
+                xml.hasAttribute("class") ? xml.attribute("class") : xml.attribute("type")
+            );
+            spawn.group = group;
+            spawn.x = xml.floatAttribute("x");
+            spawn.y = xml.floatAttribute("y");
+            spawn.width = xml.floatAttribute("width");
+            spawn.height = xml.floatAttribute("height");
+            if (xml.hasAttribute("gid")) {
+                // Tile objects are anchored at their bottom-left corner and
+                // may leave the size out (it's then the tile's size)
+                if (!xml.hasAttribute("width")) spawn.width = static_cast<float>(tile_width);
+                if (!xml.hasAttribute("height")) spawn.height = static_cast<float>(tile_height);
+                spawn.y -= spawn.height;
+            }
+        }
+    }
+
+    if (tile_width <= 0 || tile_height <= 0) {
+        throw std::runtime_error(std::string("Missing <map> element in ") + path);
+    }
+
+    // Lay the tilesets' collision tables out by gid so the layers' tile ids
+    // can index the combined table directly
+    for (const TmxTileset& entry : tilesets) {
+        const std::vector<CollisionLayer>& lut = entry.tileset.getCollisionLut();
+        size_t offset = static_cast<size_t>(std::max(0, entry.firstGid - 1));
+        size_t count = std::max(lut.size(), static_cast<size_t>(entry.tileset.getTileCount()));
+        if (collision_lut.size() < offset + count) {
+            collision_lut.resize(offset + count, CollisionLayer::NONE);
+        }
+        std::copy(lut.begin(), lut.end(), collision_lut.begin() + offset);
+    }
+}
+
+const TmxLayer* TmxMap::findLayer(std::string_view layerName) const {
+    for (const TmxLayer& layer : layers) {
+        if (layer.name == layerName) return &layer;
+    }
+    return nullptr;
+}
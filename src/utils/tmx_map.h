@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "tileset.h"
+#include "collisions_defs.h"
+
+// Flip bits stored per cell in TmxLayer::flips
+enum TileFlip : uint8_t {
+    TILE_FLIP_NONE = 0,
+    TILE_FLIP_HORIZONTAL = 1 << 0,
+    TILE_FLIP_VERTICAL = 1 << 1,
+    TILE_FLIP_DIAGONAL = 1 << 2, // Anti-diagonal, i.e. rotated 90 degrees
+};
+
+// One tile layer, already decoded
+struct TmxLayer {
+    std::string name;
+    bool visible = true;
+    float opacity = 1.0f;
+    int width = 0;
+    int height = 0;
+    // Row-major tile ids, -1 for empty cells. Ids are gid - 1, so tilesets
+    // sit back to back: tileset k owns [firstGid_k - 1, firstGid_k - 1 + count)
+    std::vector<int> tiles;
+    std::vector<uint8_t> flips; // TileFlip bits per cell
+};
+
+// An object from an object layer, used as a spawn point
+struct SpawnPoint {
+    std::string name;
+    std::string type;  // Tiled "class" (or "type" in older files)
+    std::string group; // Name of the object layer it came from
+    float x = 0.0f;    // World position of the object's top-left corner (tile
+    float y = 0.0f;    // objects, anchored bottom-left in Tiled, are moved up)
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+struct TmxTileset {
+    int firstGid = 1;
+    Tileset tileset;
+};
+
+// Loads a Tiled map (.tmx) straight into tile arrays.
+// Supports CSV, XML and base64 layer data (raw, zlib or gzip compressed),
+// external and embedded tilesets, flip flags and object layers. Infinite
+// (chunked) maps are not supported.
+class TmxMap {
+public:
+    explicit TmxMap(const char* path);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getTileWidth() const { return tile_width; }
+    int getTileHeight() const { return tile_height; }
+
+    const std::vector<TmxLayer>& getLayers() const { return layers; }
+    const TmxLayer* findLayer(std::string_view layerName) const;
+    const std::vector<TmxTileset>& getTilesets() const { return tilesets; }
+    const std::vector<SpawnPoint>& getSpawnPoints() const { return spawns; }
+
+    // Collision layer for every tile id used by the layers, built from the
+    // tilesets' "collision" properties
+    const std::vector<CollisionLayer>& getCollisionLut() const { return collision_lut; }
+
+private:
+    int width = 0;
+    int height = 0;
+    int tile_width = 0;
+    int tile_height = 0;
+    std::vector<TmxLayer> layers;
+    std::vector<TmxTileset> tilesets;
+    std::vector<SpawnPoint> spawns;
+    std::vector<CollisionLayer> collision_lut;
+};
@@ -0,0 +1,256 @@
+#include "visibility.h"
+#include <cmath>     // For std::floor
+#include <cstdlib>   // For std::abs
+#include <algorithm> // For std::max, std::min
+
+VisibilityService::~VisibilityService() {
+    if (map) map->removeListener(this);
+}
+
+void VisibilityService::beginFrame(const Tilemap* newMap) {
+    if (newMap != map) {
+        if (map) map->removeListener(this);
+        map = newMap;
+        if (map) map->addListener(this);
+        invalidate();
+    }
+}
+
+void VisibilityService::onTilemapDestroyed(const Tilemap& destroyedMap) {
+    if (&destroyedMap != map) return;
+    map = nullptr;
+    invalidate();
+}
+
+void VisibilityService::onTilesChanged(
+    const Tilemap& changedMap, const std::vector<TileRect>& regions
+) {
+    if (&changedMap != map) return;
+    const int width = map->getMapWidth();
+    const int height = map->getMapHeight();
+
+    if (editClock == UINT32_MAX) {
+        invalidate(); // Stamps would wrap
+        return;
+    }
+    ++editClock;
+
+    // Regions in window-relative coordinates, like the cache keys
+    const int blocksY = (height + EDIT_BLOCK - 1) / EDIT_BLOCK;
+    for (const TileRect& region : regions) {
+        TileRect r{region.x - map->getOriginX(), region.y, region.w, region.h};
+        if (r.x <= 0 && r.y <= 0 && r.x + r.w >= width && r.y + r.h >= height) {
+            invalidate(); // Whole window, e.g. after scrolling
+            return;
+        }
+        int x0 = std::max(r.x, 0) / EDIT_BLOCK;
+        int y0 = std::max(r.y, 0) / EDIT_BLOCK;
+        int x1 = std::min(r.x + r.w, width) - 1;
+        int y1 = std::min(r.y + r.h, height) - 1;
+        if (x1 < 0 || y1 < 0) continue;
+        x1 = std::min(x1 / EDIT_BLOCK, blocksX - 1);
+        y1 = std::min(y1 / EDIT_BLOCK, blocksY - 1);
+        for (int by = y0; by <= y1; ++by) {
+            for (int bx = x0; bx <= x1; ++bx) {
+                blockEdited[by * blocksX + bx] = editClock;
+            }
+        }
+
+        // A line between two tile centers stays inside the tiles' bounding
+        // box, so the target's set only changes if its square touches a region
+        if (targetValid && targetTileX - targetRadius < r.x + r.w && r.x <= targetTileX + targetRadius &&
+            targetTileY - targetRadius < r.y + r.h && r.y <= targetTileY + targetRadius) {
+            targetStale = true;
+        }
+    }
+}
+
+void VisibilityService::invalidate() {
+    std::fill(cache.begin(), cache.end(), CacheSlot());
+    editClock = 0;
+    targetValid = false;
+    targetOffMap = false;
+    targetStale = false;
+    if (map) {
+        targetVisible.assign(map->getMapWidth() * map->getMapHeight(), 0);
+        blocksX = (map->getMapWidth() + EDIT_BLOCK - 1) / EDIT_BLOCK;
+        int blocksY = (map->getMapHeight() + EDIT_BLOCK - 1) / EDIT_BLOCK;
+        blockEdited.assign(blocksX * blocksY, 0);
+    } else {
+        targetVisible.clear();
+        blockEdited.clear();
+        blocksX = 0;
+    }
+}
+
+bool VisibilityService::unchangedSince(int x0, int y0, int x1, int y1, uint32_t stamp) const {
+    for (int by = y0 / EDIT_BLOCK; by <= y1 / EDIT_BLOCK; ++by) {
+        const uint32_t* row = blockEdited.data() + by * blocksX;
+        for (int bx = x0 / EDIT_BLOCK; bx <= x1 / EDIT_BLOCK; ++bx) {
+            if (row[bx] > stamp) return false;
+        }
+    }
+    return true;
+}
+
+bool VisibilityService::worldToTile(float x, float y, int& tileX, int& tileY) const {
+    if (!map) return false;
+    // Tile coordinates here are relative to the map's window
+    tileX = static_cast<int>(std::floor(x / map->getTileWidth())) - map->getOriginX();
+    tileY = static_cast<int>(std::floor(y / map->getTileHeight()));
+    return tileX >= 0 && tileX < map->getMapWidth() && tileY >= 0 &&
+           tileY < map->getMapHeight();
+}
+
+bool VisibilityService::canSee(
+    float fromX, float fromY, float toX, float toY, CollisionLayer mask
+) {
+    int ax, ay, bx, by;
+    if (!worldToTile(fromX, fromY, ax, ay) || !worldToTile(toX, toY, bx, by)) {
+        // Off the map nothing blocks sight
+        return true;
+    }
+    return tilesCanSee(ax, ay, bx, by, mask);
+}
+
+void VisibilityService::canSeeBatch(
+    const std::vector<Query>& queries, std::vector<uint8_t>& out
+) {
+    out.resize(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const Query& q = queries[i];
+        out[i] = canSee(q.fromX, q.fromY, q.toX, q.toY, q.mask) ? 1 : 0;
+    }
+}
+
+void VisibilityService::setTarget(float x, float y, CollisionLayer mask, int radius) {
+    int tx, ty;
+    // Off the map nothing blocks sight, as in canSee(). The old set is kept
+    // (still marked valid) so it can be cleared or reused when the target
+    // comes back.
+    targetOffMap = map && !worldToTile(x, y, tx, ty);
+    if (!map || targetOffMap) return;
+    if (targetValid && !targetStale && tx == targetTileX && ty == targetTileY &&
+        mask == targetMask && radius == targetRadius) {
+        return; // Still valid
+    }
+
+    // Clear the old set only where it was written
+    if (targetValid) {
+        int x0 = std::max(0, targetTileX - targetRadius);
+        int x1 = std::min(map->getMapWidth() - 1, targetTileX + targetRadius);
+        int y0 = std::max(0, targetTileY - targetRadius);
+        int y1 = std::min(map->getMapHeight() - 1, targetTileY + targetRadius);
+        for (int cy = y0; cy <= y1; ++cy) {
+            std::fill(
+                targetVisible.begin() + cy * map->getMapWidth() + x0,
+                targetVisible.begin() + cy * map->getMapWidth() + x1 + 1, 0
+            );
+        }
+    }
+
+    targetTileX = tx;
+    targetTileY = ty;
+    targetMask = mask;
+    targetRadius = radius;
+    targetValid = true;
+    targetStale = false;
+
+    int x0 = std::max(0, tx - radius);
+    int x1 = std::min(map->getMapWidth() - 1, tx + radius);
+    int y0 = std::max(0, ty - radius);
+    int y1 = std::min(map->getMapHeight() - 1, ty + radius);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            targetVisible[cy * map->getMapWidth() + cx] =
+                walkLine(cx, cy, tx, ty, mask) ? 1 : 0;
+        }
+    }
+}
+
+bool VisibilityService::targetVisibleFrom(float x, float y) {
+    int tx, ty;
+    if (targetOffMap) return true;
+    if (!targetValid) return false;
+    if (!worldToTile(x, y, tx, ty)) return true; // Off the map nothing blocks sight
+    if (targetStale || std::abs(tx - targetTileX) > targetRadius ||
+        std::abs(ty - targetTileY) > targetRadius) {
+        return tilesCanSee(tx, ty, targetTileX, targetTileY, targetMask);
+    }
+    return targetVisible[ty * map->getMapWidth() + tx] != 0;
+}
+
+bool VisibilityService::tilesCanSee(
+    int ax, int ay, int bx, int by, CollisionLayer mask
+) {
+    // Order the pair so A->B and B->A share one cache entry
+    uint32_t a = static_cast<uint32_t>(ay * map->getMapWidth() + ax);
+    uint32_t b = static_cast<uint32_t>(by * map->getMapWidth() + bx);
+    if (a > b) {
+        std::swap(a, b);
+        std::swap(ax, bx);
+        std::swap(ay, by);
+    }
+    uint64_t key = (static_cast<uint64_t>(a) << 32) | b;
+
+    // splitmix64 finalizer over the pair and mask picks the slot
+    uint64_t h = key ^ (static_cast<uint64_t>(mask) * 0x9e3779b97f4a7c15ull);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    CacheSlot& slot = cache[h & (CACHE_SLOTS - 1)];
+    if (slot.used && slot.pair == key && slot.mask == static_cast<uint32_t>(mask) &&
+        unchangedSince(std::min(ax, bx), std::min(ay, by), std::max(ax, bx), std::max(ay, by), slot.stamp)) {
+        return slot.visible;
+    }
+    bool visible = walkLine(ax, ay, bx, by, mask);
+    slot = {key, static_cast<uint32_t>(mask), editClock, true, visible}; // Evicts any other pair here
+    return visible;
+}
+
+bool VisibilityService::blocks(int tileX, int tileY, CollisionLayer mask) const {
+    return ::checkCollision(mask, map->getTileLayer(tileX + map->getOriginX(), tileY));
+}
+
+// Walks every tile the segment between the two tile centers passes through.
+// The end tiles themselves never block (the viewer may be hugging a wall).
+bool VisibilityService::walkLine(
+    int ax, int ay, int bx, int by, CollisionLayer mask
+) const {
+    int nx = std::abs(bx - ax);
+    int ny = std::abs(by - ay);
+    int stepX = (bx > ax) ? 1 : -1;
+    int stepY = (by > ay) ? 1 : -1;
+
+    int x = ax;
+    int y = ay;
+    int ix = 0;
+    int iy = 0;
+    while (ix < nx || iy < ny) {
+        // Compare where the next vertical and horizontal grid lines are hit:
+        // (0.5 + ix) / nx vs (0.5 + iy) / ny, kept in integers
+        long decision = static_cast<long>(1 + 2 * ix) * ny -
+                        static_cast<long>(1 + 2 * iy) * nx;
+        if (decision == 0) {
+            // Exactly through a corner: only blocked if both sides are
+            bool sideX = (x + stepX != bx || y != by) && blocks(x + stepX, y, mask);
+            bool sideY = (x != bx || y + stepY != by) && blocks(x, y + stepY, mask);
+            if (sideX && sideY) return false;
+            x += stepX;
+            y += stepY;
+            ++ix;
+            ++iy;
+        } else if (decision < 0) {
+            x += stepX;
+            ++ix;
+        } else {
+            y += stepY;
+            ++iy;
+        }
+
+        if ((x != bx || y != by) && blocks(x, y, mask)) {
+            return false;
+        }
+    }
+    return true;
+}
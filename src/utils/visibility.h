@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "tilemap.h"
+#include "collisions_defs.h"
+
+// Line-of-sight queries against a Tilemap.
+// Results are cached per (tile, tile, mask) so many agents asking the same
+// question in the same area only walk the grid once. The cache is a fixed
+// direct-mapped table: a new result overwrites whatever hashed to the same
+// slot, so memory stays at CACHE_SLOTS entries however long the session
+// runs. The service listens to the map and, when tiles change, stamps the
+// 8x8-tile blocks the edits touch; a cached result is only used if no block
+// under its line's bounding box was stamped after it was computed. So an
+// edit costs in proportion to its area, not to the size of the cache.
+class VisibilityService : public TilemapListener {
+public:
+    static constexpr size_t CACHE_SLOTS = 8192; // Power of two
+    static constexpr int EDIT_BLOCK = 8;         // Tiles per side of an edit block
+
+    struct Query {
+        float fromX, fromY; // World position of the viewer
+        float toX, toY;     // World position of the thing being looked at
+        CollisionLayer mask; // Tiles on any of these layers block sight
+    };
+
+    VisibilityService() = default;
+    ~VisibilityService() override;
+
+    // Registered with the map as a listener
+    VisibilityService(const VisibilityService&) = delete;
+    VisibilityService& operator=(const VisibilityService&) = delete;
+
+    // Call once per frame before any queries are made
+    void beginFrame(const Tilemap* map);
+
+    // Single query, answered from the cache when possible
+    bool canSee(float fromX, float fromY, float toX, float toY, CollisionLayer mask);
+
+    // Answers a whole frame's worth of queries in one go.
+    // out[i] is 1 if queries[i] has line of sight, 0 otherwise.
+    void canSeeBatch(const std::vector<Query>& queries, std::vector<uint8_t>& out);
+
+    // Precomputes which tiles within `radius` tiles of the target can see it.
+    // Only recomputed when the target changes tile, the mask changes or the
+    // map is edited.
+    void setTarget(float x, float y, CollisionLayer mask, int radius);
+    // O(1) lookup into the set built by setTarget(). Positions outside the
+    // precomputed radius fall back to a cached line walk. Like canSee(), a
+    // target (or viewer) off the map is always visible.
+    bool targetVisibleFrom(float x, float y);
+
+    // TilemapListener
+    void onTilesChanged(const Tilemap& changedMap, const std::vector<TileRect>& regions) override;
+    void onTilemapDestroyed(const Tilemap& destroyedMap) override;
+
+private:
+    const Tilemap* map = nullptr;
+
+    struct CacheSlot {
+        uint64_t pair = 0;  // Packed tile pair, lower index first
+        uint32_t mask = 0;
+        uint32_t stamp = 0; // editClock when the line was walked
+        bool used = false;
+        bool visible = false;
+    };
+    std::vector<CacheSlot> cache = std::vector<CacheSlot>(CACHE_SLOTS);
+
+    // editClock value of the last edit in each EDIT_BLOCK block
+    std::vector<uint32_t> blockEdited;
+    int blocksX = 0;
+    uint32_t editClock = 0;
+
+    // Visible set for the current target
+    std::vector<uint8_t> targetVisible;
+    int targetTileX = -1;
+    int targetTileY = -1;
+    int targetRadius = 0;
+    CollisionLayer targetMask = CollisionLayer::NONE;
+    bool targetValid = false;
+    bool targetOffMap = false; // Last setTarget() was off the map
+    bool targetStale = false; // Tiles in the radius changed since setTarget
+
+    void invalidate();
+    // True if no block in the tile box [x0, x1] x [y0, y1] changed after `stamp`
+    bool unchangedSince(int x0, int y0, int x1, int y1, uint32_t stamp) const;
+    bool worldToTile(float x, float y, int& tileX, int& tileY) const;
+    bool tilesCanSee(int ax, int ay, int bx, int by, CollisionLayer mask);
+    // Walks the grid between two tile centers; does not touch the cache
+    bool walkLine(int ax, int ay, int bx, int by, CollisionLayer mask) const;
+    bool blocks(int tileX, int tileY, CollisionLayer mask) const;
+};
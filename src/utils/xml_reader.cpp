@@ -0,0 +1,150 @@
+#include "xml_reader.h"
+#include <charconv>
+#include <cstdlib> // For std::strtof
+
+namespace {
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+} // namespace
+
+XmlReader::XmlReader(std::string_view document) : doc(document) {}
+
+bool XmlReader::next() {
+    while (true) {
+        size_t open = doc.find('<', pos);
+        if (open == std::string_view::npos) {
+            pos = doc.size();
+            return false;
+        }
+
+        // Skip comments, CDATA, declarations and processing instructions
+        if (doc.compare(open, 4, "<!--") == 0) {
+            size_t end = doc.find("-->", open + 4);
+            pos = (end == std::string_view::npos) ? doc.size() : end + 3;
+            continue;
+        }
+        if (doc.compare(open, 9, "<![CDATA[") == 0) {
+            size_t end = doc.find("]]>", open + 9);
+            pos = (end == std::string_view::npos) ? doc.size() : end + 3;
+            continue;
+        }
+        if (open + 1 < doc.size() && (doc[open + 1] == '?' || doc[open + 1] == '!')) {
+            size_t end = doc.find('>', open);
+            pos = (end == std::string_view::npos) ? doc.size() : end + 1;
+            continue;
+        }
+
+        // Find the end of the tag, ignoring '>' inside quoted values
+        size_t end = open + 1;
+        char quote = 0;
+        while (end < doc.size()) {
+            char c = doc[end];
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                break;
+            }
+            ++end;
+        }
+        if (end >= doc.size()) {
+            pos = doc.size();
+            return false; // Truncated document
+        }
+
+        std::string_view body = doc.substr(open + 1, end - open - 1);
+        tagStart = open;
+        pos = end + 1;
+
+        closing = !body.empty() && body.front() == '/';
+        if (closing) body.remove_prefix(1);
+        selfClosing = !body.empty() && body.back() == '/';
+        if (selfClosing) body.remove_suffix(1);
+
+        size_t nameEnd = 0;
+        while (nameEnd < body.size() && !isSpace(body[nameEnd])) ++nameEnd;
+        tagName = body.substr(0, nameEnd);
+        parseAttributes(body.substr(nameEnd));
+        return true;
+    }
+}
+
+void XmlReader::parseAttributes(std::string_view body) {
+    attributes.clear();
+    size_t i = 0;
+    while (i < body.size()) {
+        while (i < body.size() && isSpace(body[i])) ++i;
+        size_t nameStart = i;
+        while (i < body.size() && body[i] != '=' && !isSpace(body[i])) ++i;
+        std::string_view attrName = body.substr(nameStart, i - nameStart);
+        while (i < body.size() && body[i] != '"' && body[i] != '\'') ++i;
+        if (i >= body.size()) break;
+        char quote = body[i++];
+        size_t valueStart = i;
+        while (i < body.size() && body[i] != quote) ++i;
+        if (!attrName.empty()) {
+            attributes.push_back({attrName, body.substr(valueStart, i - valueStart)});
+        }
+        ++i; // Closing quote
+    }
+}
+
+std::string_view XmlReader::attribute(std::string_view attrName) const {
+    for (const Attribute& attr : attributes) {
+        if (attr.name == attrName) return attr.value;
+    }
+    return {};
+}
+
+bool XmlReader::hasAttribute(std::string_view attrName) const {
+    for (const Attribute& attr : attributes) {
+        if (attr.name == attrName) return true;
+    }
+    return false;
+}
+
+int XmlReader::intAttribute(std::string_view attrName, int fallback) const {
+    std::string_view value = attribute(attrName);
+    int result = fallback;
+    if (!value.empty()) {
+        std::from_chars(value.data(), value.data() + value.size(), result);
+    }
+    return result;
+}
+
+float XmlReader::floatAttribute(std::string_view attrName, float fallback) const {
+    std::string_view value = attribute(attrName);
+    if (value.empty()) return fallback;
+    // Attribute values are followed by a quote, so strtof stops in time
+    char* end = nullptr;
+    float result = std::strtof(value.data(), &end);
+    return (end == value.data()) ? fallback : result;
+}
+
+std::string_view XmlReader::text() const {
+    size_t end = doc.find('<', pos);
+    if (end == std::string_view::npos) end = doc.size();
+    return doc.substr(pos, end - pos);
+}
+
+void XmlReader::skipElement() {
+    if (closing || selfClosing) return;
+    std::string_view element = tagName;
+    int depth = 1;
+    while (depth > 0 && next()) {
+        if (tagName != element) continue;
+        if (closing) {
+            --depth;
+        } else if (!selfClosing) {
+            ++depth;
+        }
+    }
+}
+
+std::string_view XmlReader::elementSource() {
+    size_t start = tagStart;
+    skipElement();
+    return doc.substr(start, pos - start);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <string_view>
+#include <vector>
+
+// Minimal forward-only XML tag scanner for the Tiled formats (.tsx, .tmx).
+// It walks element tags in document order and hands out views into the
+// original buffer, so nothing is copied or allocated per tag once the
+// attribute list has warmed up. Not a validating parser: comments,
+// declarations and CDATA are skipped, and entities are not decoded.
+class XmlReader {
+public:
+    explicit XmlReader(std::string_view document);
+
+    // Moves to the next element tag. Returns false at end of document.
+    bool next();
+
+    std::string_view name() const { return tagName; }
+    bool isClosing() const { return closing; }
+    bool isSelfClosing() const { return selfClosing; }
+
+    // Attribute value of the current tag, or an empty view if it's missing
+    std::string_view attribute(std::string_view attrName) const;
+    bool hasAttribute(std::string_view attrName) const;
+    int intAttribute(std::string_view attrName, int fallback = 0) const;
+    float floatAttribute(std::string_view attrName, float fallback = 0.0f) const;
+
+    // Raw character data between the end of the current tag and the next '<'
+    std::string_view text() const;
+
+    // Skips past the closing tag of the current element (no-op for
+    // self-closing tags)
+    void skipElement();
+
+    // Skips the current element like skipElement() and returns its full
+    // source text, from the opening '<' to the end of the closing tag
+    std::string_view elementSource();
+
+private:
+    struct Attribute {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    std::string_view doc;
+    size_t pos = 0;
+    size_t tagStart = 0; // Offset of the current tag's '<'
+
+    std::string_view tagName;
+    bool closing = false;
+    bool selfClosing = false;
+    std::vector<Attribute> attributes;
+
+    void parseAttributes(std::string_view body);
+};
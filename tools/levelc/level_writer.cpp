@@ -0,0 +1,164 @@
+#include "level_writer.h"
+#include <algorithm> // For std::copy, std::min
+#include <cstring>   // For std::memcpy
+#include <fstream>
+#include <stdexcept>
+#include "utils/level_format.h"
+
+using namespace level_format;
+
+namespace {
+// Deduplicating string table; offset 0 is always the empty string
+class StringTable {
+public:
+    StringTable() { data.push_back('\0'); }
+
+    uint32_t add(const std::string& text) {
+        if (text.empty()) return 0;
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            if (texts[i] == text) return offsets[i];
+        }
+        uint32_t offset = static_cast<uint32_t>(data.size());
+        data.insert(data.end(), text.begin(), text.end());
+        data.push_back('\0');
+        texts.push_back(text);
+        offsets.push_back(offset);
+        return offset;
+    }
+
+    const std::vector<char>& bytes() const { return data; }
+
+private:
+    std::vector<char> data;
+    std::vector<std::string> texts;
+    std::vector<uint32_t> offsets;
+};
+
+template <typename T>
+void put(std::vector<uint8_t>& out, uint64_t offset, const T& value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+} // namespace
+
+void writeLevel(const LevelData& level, const std::string& path) {
+    if (level.width <= 0 || level.height <= 0) {
+        throw std::runtime_error("Level has no tiles");
+    }
+    const uint64_t cells = uint64_t(level.width) * uint64_t(level.height);
+    for (const TmxLayer& layer : level.layers) {
+        if (layer.tiles.size() != cells || layer.flips.size() != cells) {
+            throw std::runtime_error("Layer '" + layer.name + "' doesn't match the level size");
+        }
+    }
+
+    StringTable strings;
+    std::vector<LayerEntry> layerTable(level.layers.size());
+    for (size_t i = 0; i < level.layers.size(); ++i) {
+        layerTable[i] = {};
+        layerTable[i].nameOffset = strings.add(level.layers[i].name);
+        layerTable[i].flags = level.layers[i].visible ? LAYER_VISIBLE : 0;
+        layerTable[i].opacity = level.layers[i].opacity;
+    }
+
+    std::vector<SpawnEntry> spawnTable(level.spawns.size());
+    for (size_t i = 0; i < level.spawns.size(); ++i) {
+        const SpawnPoint& spawn = level.spawns[i];
+        spawnTable[i] = {};
+        spawnTable[i].nameOffset = strings.add(spawn.name);
+        spawnTable[i].typeOffset = strings.add(spawn.type);
+        spawnTable[i].groupOffset = strings.add(spawn.group);
+        spawnTable[i].x = spawn.x;
+        spawnTable[i].y = spawn.y;
+        spawnTable[i].width = spawn.width;
+        spawnTable[i].height = spawn.height;
+    }
+
+    // Chunk index: what each CHUNK_COLUMNS wide strip contains
+    auto layerOf = [&](int tile) {
+        return (static_cast<unsigned>(tile) < level.collisionLut.size())
+                   ? static_cast<uint32_t>(level.collisionLut[tile])
+                   : 0u;
+    };
+    int chunkCount = (level.width + CHUNK_COLUMNS - 1) / CHUNK_COLUMNS;
+    std::vector<ChunkEntry> chunkTable(chunkCount);
+    for (int c = 0; c < chunkCount; ++c) {
+        ChunkEntry& chunk = chunkTable[c];
+        chunk = {};
+        chunk.firstColumn = c * CHUNK_COLUMNS;
+        chunk.columns = std::min(CHUNK_COLUMNS, level.width - chunk.firstColumn);
+        for (const TmxLayer& layer : level.layers) {
+            for (int y = 0; y < level.height; ++y) {
+                for (int x = chunk.firstColumn; x < chunk.firstColumn + chunk.columns; ++x) {
+                    int tile = layer.tiles[size_t(y) * level.width + x];
+                    if (tile < 0) continue;
+                    chunk.collisionLayers |= layerOf(tile);
+                    ++chunk.tileCount;
+                }
+            }
+        }
+    }
+
+    // Lay out the sections
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.width = level.width;
+    header.height = level.height;
+    header.tileWidth = level.tileWidth;
+    header.tileHeight = level.tileHeight;
+    header.layerCount = static_cast<uint32_t>(layerTable.size());
+    header.lutCount = static_cast<uint32_t>(level.collisionLut.size());
+    header.spawnCount = static_cast<uint32_t>(spawnTable.size());
+    header.chunkCount = static_cast<uint32_t>(chunkTable.size());
+
+    uint64_t offset = alignUp(sizeof(Header));
+    header.layersOffset = offset;
+    offset = alignUp(offset + layerTable.size() * sizeof(LayerEntry));
+    header.lutOffset = offset;
+    offset = alignUp(offset + level.collisionLut.size() * sizeof(uint32_t));
+    header.spawnsOffset = offset;
+    offset = alignUp(offset + spawnTable.size() * sizeof(SpawnEntry));
+    header.chunksOffset = offset;
+    offset = alignUp(offset + chunkTable.size() * sizeof(ChunkEntry));
+    for (LayerEntry& entry : layerTable) {
+        entry.tilesOffset = offset;
+        offset = alignUp(offset + cells * sizeof(int32_t));
+        entry.flipsOffset = offset;
+        offset = alignUp(offset + cells);
+    }
+    header.stringsOffset = offset;
+    header.stringsSize = strings.bytes().size();
+    header.fileSize = offset + header.stringsSize;
+
+    // Fill the image (padding stays zero)
+    std::vector<uint8_t> out(header.fileSize, 0);
+    put(out, 0, header);
+    for (size_t i = 0; i < layerTable.size(); ++i) {
+        put(out, header.layersOffset + i * sizeof(LayerEntry), layerTable[i]);
+        const TmxLayer& layer = level.layers[i];
+        for (uint64_t cell = 0; cell < cells; ++cell) {
+            put(out, layerTable[i].tilesOffset + cell * sizeof(int32_t), int32_t(layer.tiles[cell]));
+        }
+        std::copy(layer.flips.begin(), layer.flips.end(), out.begin() + layerTable[i].flipsOffset);
+    }
+    for (size_t i = 0; i < level.collisionLut.size(); ++i) {
+        put(out, header.lutOffset + i * sizeof(uint32_t), static_cast<uint32_t>(level.collisionLut[i]));
+    }
+    for (size_t i = 0; i < spawnTable.size(); ++i) {
+        put(out, header.spawnsOffset + i * sizeof(SpawnEntry), spawnTable[i]);
+    }
+    for (size_t i = 0; i < chunkTable.size(); ++i) {
+        put(out, header.chunksOffset + i * sizeof(ChunkEntry), chunkTable[i]);
+    }
+    std::copy(strings.bytes().begin(), strings.bytes().end(), out.begin() + header.stringsOffset);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open output file: " + path);
+    }
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    if (!file) {
+        throw std::runtime_error("Failed to write output file: " + path);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "utils/collisions_defs.h"
+#include "utils/tmx_map.h"
+
+// Everything that goes into a compiled level, independent of the source
+// format it came from
+struct LevelData {
+    int width = 0;
+    int height = 0;
+    int tileWidth = 16;
+    int tileHeight = 16;
+    std::vector<TmxLayer> layers; // All width x height
+    std::vector<CollisionLayer> collisionLut;
+    std::vector<SpawnPoint> spawns;
+};
+
+// Lays `level` out as described in utils/level_format.h and writes it to
+// `path`. Throws std::runtime_error on failure.
+void writeLevel(const LevelData& level, const std::string& path);
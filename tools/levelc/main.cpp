@@ -0,0 +1,161 @@
+// levelc: compiles Tiled (.tmx) or text (.txt) maps into the binary level
+// format the game memory-maps at runtime (see utils/level_format.h).
+//
+//   levelc [--tileset file.tsx] [--tile-size WxH] -o out.lvl map.tmx
+//   levelc [--tileset file.tsx] [--tile-size WxH] -o out.lvl a.txt [b.txt ...]
+//
+// A .tmx brings its own layers, tilesets and object layers. Text maps (see
+// utils/text_map.h) each become one layer named after the file, and
+// --tileset supplies the collision table.
+#include <algorithm> // For std::max, std::copy
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "level_writer.h"
+#include "utils/text_map.h"
+#include "utils/tileset.h"
+#include "utils/tmx_map.h"
+
+namespace {
+bool endsWith(const std::string& text, const char* suffix) {
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+// File name without directory or extension
+std::string stem(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return (dot == std::string::npos) ? name : name.substr(0, dot);
+}
+
+LevelData fromTmx(const std::string& path) {
+    TmxMap map(path.c_str());
+    LevelData level;
+    level.width = map.getWidth();
+    level.height = map.getHeight();
+    level.tileWidth = map.getTileWidth();
+    level.tileHeight = map.getTileHeight();
+    level.collisionLut = map.getCollisionLut();
+    level.spawns = map.getSpawnPoints();
+    for (const TmxLayer& layer : map.getLayers()) {
+        if (layer.width != level.width || layer.height != level.height) {
+            std::cerr << "Warning: skipping layer '" << layer.name
+                      << "', its size doesn't match the map" << std::endl;
+            continue;
+        }
+        level.layers.push_back(layer);
+    }
+    return level;
+}
+
+LevelData fromTextMaps(const std::vector<std::string>& paths) {
+    std::vector<TextMap> maps;
+    LevelData level;
+    for (const std::string& path : paths) {
+        maps.push_back(loadTextMap(path.c_str()));
+        level.width = std::max(level.width, maps.back().width);
+        level.height = std::max(level.height, maps.back().height);
+    }
+
+    // Layers share one size; smaller maps are padded with empty tiles
+    for (size_t i = 0; i < paths.size(); ++i) {
+        TmxLayer& layer = level.layers.emplace_back();
+        layer.name = stem(paths[i]);
+        layer.width = level.width;
+        layer.height = level.height;
+        layer.tiles.assign(size_t(level.width) * level.height, -1);
+        layer.flips.assign(layer.tiles.size(), TILE_FLIP_NONE);
+
+        const TextMap& map = maps[i];
+        for (int y = 0; y < map.height; ++y) {
+            auto row = map.tiles.begin() + size_t(y) * map.width;
+            std::copy(row, row + map.width, layer.tiles.begin() + size_t(y) * level.width);
+        }
+        if (map.width != level.width || map.height != level.height) {
+            std::cerr << "Warning: " << paths[i] << " is " << map.width << "x" << map.height
+                      << ", padding to " << level.width << "x" << level.height << std::endl;
+        }
+    }
+    return level;
+}
+
+void usage() {
+    std::cerr << "usage: levelc [--tileset file.tsx] [--tile-size WxH] -o out.lvl map.tmx\n"
+                 "       levelc [--tileset file.tsx] [--tile-size WxH] -o out.lvl a.txt [b.txt ...]"
+              << std::endl;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string output;
+    std::string tilesetPath;
+    int tileWidth = 0;
+    int tileHeight = 0;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--tileset" && i + 1 < argc) {
+            tilesetPath = argv[++i];
+        } else if (arg == "--tile-size" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &tileWidth, &tileHeight) != 2 ||
+                tileWidth <= 0 || tileHeight <= 0) {
+                usage();
+                return 1;
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            usage();
+            return 1;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (output.empty() || inputs.empty()) {
+        usage();
+        return 1;
+    }
+
+    try {
+        LevelData level;
+        if (inputs.size() == 1 && endsWith(inputs[0], ".tmx")) {
+            level = fromTmx(inputs[0]);
+            if (!tilesetPath.empty()) {
+                std::cerr << "Warning: --tileset is ignored for .tmx maps" << std::endl;
+            }
+        } else {
+            for (const std::string& input : inputs) {
+                if (endsWith(input, ".tmx")) {
+                    std::cerr << "A .tmx map can't be combined with other maps" << std::endl;
+                    return 1;
+                }
+            }
+            level = fromTextMaps(inputs);
+            if (!tilesetPath.empty()) {
+                Tileset tileset(tilesetPath.c_str());
+                level.collisionLut = tileset.getCollisionLut();
+                level.tileWidth = tileset.getTileWidth();
+                level.tileHeight = tileset.getTileHeight();
+            }
+        }
+        if (tileWidth > 0) {
+            level.tileWidth = tileWidth;
+            level.tileHeight = tileHeight;
+        }
+
+        writeLevel(level, output);
+        std::cout << output << ": " << level.width << "x" << level.height << " tiles, "
+                  << level.layers.size() << " layers, " << level.spawns.size() << " spawns"
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "levelc: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// levelgen_bench: measures LevelGenerator throughput and checks that the
+// same seed gives the same level.
+//
+//   levelgen_bench [--chunks N] [--size WxH] [--seed S]
+//
+// A chunk has to fit comfortably inside a frame's spare time to be made in
+// the background while the player walks, so the numbers worth watching are
+// tiles/sec and the worst single chunk.
+#include <algorithm> // For std::max
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "utils/level_generator.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// FNV-1a over a chunk's tiles, to compare runs without keeping them
+uint64_t hashTiles(uint64_t hash, const std::vector<int>& tiles) {
+    for (int tile : tiles) {
+        hash ^= static_cast<uint32_t>(tile);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+}
+
+int main(int argc, char** argv) {
+    int chunks = 20000;
+    int width = 32;
+    int height = 30;
+    uint64_t seed = 0x5EED;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--chunks") && i + 1 < argc) {
+            chunks = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                std::cerr << "Bad --size, expected WxH" << std::endl;
+                return 1;
+            }
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            std::cerr << "Usage: levelgen_bench [--chunks N] [--size WxH] [--seed S]" << std::endl;
+            return 1;
+        }
+    }
+
+    LevelGenerator generator(seed, GeneratorTiles());
+    std::vector<int> tiles;
+    std::vector<GeneratedSpawn> spawns;
+
+    // Two passes: the second must hash identically, in reverse order to
+    // show chunks don't depend on what was generated before them
+    uint64_t forwardHash = 0xCBF29CE484222325ull;
+    double worstMs = 0.0;
+    Clock::time_point start = Clock::now();
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        Clock::time_point chunkStart = Clock::now();
+        spawns.clear();
+        generator.generateChunk(chunk, width, height, tiles, &spawns);
+        worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(Clock::now() - chunkStart).count());
+        forwardHash = hashTiles(forwardHash, tiles);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<uint64_t> chunkHashes(chunks);
+    for (int chunk = chunks - 1; chunk >= 0; --chunk) {
+        generator.generateChunk(chunk, width, height, tiles);
+        chunkHashes[chunk] = hashTiles(0, tiles);
+    }
+    uint64_t reverseHash = 0xCBF29CE484222325ull;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        generator.generateChunk(chunk, width, height, tiles);
+        if (hashTiles(0, tiles) != chunkHashes[chunk]) {
+            std::cerr << "Chunk " << chunk << " differs between runs" << std::endl;
+            return 1;
+        }
+        reverseHash = hashTiles(reverseHash, tiles);
+    }
+    if (reverseHash != forwardHash) {
+        std::cerr << "Level differs between runs" << std::endl;
+        return 1;
+    }
+
+    double tileCount = static_cast<double>(chunks) * width * height;
+    std::printf("%d chunks of %dx%d, seed 0x%llx\n", chunks, width, height, static_cast<unsigned long long>(seed));
+    std::printf("  %.1f Mtiles/sec, %.3f ms/chunk average, %.3f ms worst\n",
+                tileCount / seconds / 1e6, seconds * 1000.0 / chunks, worstMs);
+    std::printf("  level hash %016llx (deterministic)\n", static_cast<unsigned long long>(forwardHash));
+    return 0;
+}
@@ -0,0 +1,235 @@
+// soundbank: packs sound effects and music into the sound bank format the
+// game memory-maps at runtime (see utils/sound_bank_format.h).
+//
+//   soundbank [--rate HZ] [--channels N] -o out.sbk
+//             [--music name=file.mp3 ...] [name=file.wav[:priority[:maxVoices]] ...]
+//
+// Sound effects are decoded here, once, to the mixer format the game opens
+// (AudioSystem::init defaults: 44100 Hz, MIX_DEFAULT_FORMAT, stereo), so
+// anything SDL_mixer can load works as input. Music files are stored as
+// they are and streamed by the game.
+#define SDL_MAIN_HANDLED // A plain command-line main
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <algorithm> // For std::copy
+#include <cstdlib>
+#include <cstring> // For std::memcpy
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "utils/sound_bank_format.h"
+
+using namespace sound_bank_format;
+
+namespace {
+struct Input {
+    std::string name;
+    std::string path;
+    int priority = 0;
+    int maxVoices = 4;
+};
+
+struct Packed {
+    std::string name;
+    std::vector<uint8_t> bytes;
+    SoundEntry entry{};
+};
+
+// name=path[:priority[:maxVoices]]
+Input parseInput(const std::string& arg, bool options) {
+    size_t equals = arg.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        throw std::runtime_error("expected name=file, got " + arg);
+    }
+    Input input;
+    input.name = arg.substr(0, equals);
+    input.path = arg.substr(equals + 1);
+    if (options) {
+        size_t colon = input.path.find(':');
+        if (colon != std::string::npos) {
+            std::string rest = input.path.substr(colon + 1);
+            input.path.erase(colon);
+            input.priority = std::atoi(rest.c_str());
+            size_t second = rest.find(':');
+            if (second != std::string::npos) {
+                input.maxVoices = std::atoi(rest.c_str() + second + 1);
+            }
+        }
+    }
+    return input;
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    return bytes;
+}
+
+uint32_t addString(std::vector<char>& strings, const std::string& text) {
+    uint32_t offset = static_cast<uint32_t>(strings.size());
+    strings.insert(strings.end(), text.begin(), text.end());
+    strings.push_back('\0');
+    return offset;
+}
+
+template <typename T>
+void put(std::vector<uint8_t>& out, uint64_t offset, const T& value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+void usage() {
+    std::cerr << "usage: soundbank [--rate HZ] [--channels N] -o out.sbk\n"
+                 "                 [--music name=file ...] [name=file[:priority[:maxVoices]] ...]"
+              << std::endl;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string output;
+    int rate = 44100;
+    int channels = 2;
+    std::vector<Input> soundInputs;
+    std::vector<Input> musicInputs;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-o" && i + 1 < argc) {
+                output = argv[++i];
+            } else if (arg == "--rate" && i + 1 < argc) {
+                rate = std::atoi(argv[++i]);
+            } else if (arg == "--channels" && i + 1 < argc) {
+                channels = std::atoi(argv[++i]);
+            } else if (arg == "--music" && i + 1 < argc) {
+                musicInputs.push_back(parseInput(argv[++i], false));
+            } else if (!arg.empty() && arg[0] == '-') {
+                usage();
+                return 1;
+            } else {
+                soundInputs.push_back(parseInput(arg, true));
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "soundbank: " << e.what() << std::endl;
+        usage();
+        return 1;
+    }
+    if (output.empty() || rate <= 0 || channels <= 0 || (soundInputs.empty() && musicInputs.empty())) {
+        usage();
+        return 1;
+    }
+
+    // A silent device is enough for SDL_mixer to decode into its format
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_AUDIO) < 0 || Mix_OpenAudio(rate, MIX_DEFAULT_FORMAT, channels, 2048) < 0) {
+        std::cerr << "soundbank: couldn't open the mixer: " << Mix_GetError() << std::endl;
+        return 1;
+    }
+    int openedRate = 0;
+    Uint16 openedFormat = 0;
+    int openedChannels = 0;
+    Mix_QuerySpec(&openedRate, &openedFormat, &openedChannels);
+
+    int status = 0;
+    try {
+        std::vector<Packed> sounds;
+        for (const Input& input : soundInputs) {
+            Mix_Chunk* chunk = Mix_LoadWAV(input.path.c_str());
+            if (!chunk) {
+                throw std::runtime_error("Failed to decode " + input.path + ": " + Mix_GetError());
+            }
+            Packed& sound = sounds.emplace_back();
+            sound.name = input.name;
+            sound.bytes.assign(chunk->abuf, chunk->abuf + chunk->alen);
+            sound.entry.priority = input.priority;
+            sound.entry.maxVoices = input.maxVoices;
+            sound.entry.volume = MIX_MAX_VOLUME;
+            Mix_FreeChunk(chunk);
+        }
+        std::vector<Packed> tracks;
+        for (const Input& input : musicInputs) {
+            // Only checked here; the game does the decoding as it streams
+            Mix_Music* music = Mix_LoadMUS(input.path.c_str());
+            if (!music) {
+                throw std::runtime_error("Can't play " + input.path + ": " + Mix_GetError());
+            }
+            Mix_FreeMusic(music);
+            Packed& track = tracks.emplace_back();
+            track.name = input.name;
+            track.bytes = readFile(input.path);
+        }
+
+        // Lay out the sections
+        std::vector<char> strings(1, '\0');
+        Header header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.frequency = openedRate;
+        header.format = openedFormat;
+        header.channels = static_cast<uint16_t>(openedChannels);
+        header.soundCount = static_cast<uint32_t>(sounds.size());
+        header.musicCount = static_cast<uint32_t>(tracks.size());
+
+        uint64_t offset = alignUp(sizeof(Header));
+        header.soundsOffset = offset;
+        offset = alignUp(offset + sounds.size() * sizeof(SoundEntry));
+        header.musicOffset = offset;
+        offset = alignUp(offset + tracks.size() * sizeof(MusicEntry));
+        std::vector<MusicEntry> musicTable(tracks.size());
+        for (Packed& sound : sounds) {
+            sound.entry.nameOffset = addString(strings, sound.name);
+            sound.entry.dataOffset = offset;
+            sound.entry.dataSize = sound.bytes.size();
+            offset = alignUp(offset + sound.bytes.size());
+        }
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            musicTable[i].nameOffset = addString(strings, tracks[i].name);
+            musicTable[i].dataOffset = offset;
+            musicTable[i].dataSize = tracks[i].bytes.size();
+            offset = alignUp(offset + tracks[i].bytes.size());
+        }
+        header.stringsOffset = offset;
+        header.stringsSize = strings.size();
+        header.fileSize = offset + header.stringsSize;
+
+        // Fill the image (padding stays zero)
+        std::vector<uint8_t> out(header.fileSize, 0);
+        put(out, 0, header);
+        for (size_t i = 0; i < sounds.size(); ++i) {
+            put(out, header.soundsOffset + i * sizeof(SoundEntry), sounds[i].entry);
+            std::copy(sounds[i].bytes.begin(), sounds[i].bytes.end(), out.begin() + sounds[i].entry.dataOffset);
+        }
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            put(out, header.musicOffset + i * sizeof(MusicEntry), musicTable[i]);
+            std::copy(tracks[i].bytes.begin(), tracks[i].bytes.end(), out.begin() + musicTable[i].dataOffset);
+        }
+        std::copy(strings.begin(), strings.end(), out.begin() + header.stringsOffset);
+
+        std::ofstream file(output, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open output file: " + output);
+        }
+        file.write(reinterpret_cast<const char*>(out.data()), out.size());
+        if (!file) {
+            throw std::runtime_error("Failed to write output file: " + output);
+        }
+        std::cout << output << ": " << sounds.size() << " sounds, " << tracks.size() << " tracks, "
+                  << openedRate << " Hz, " << openedChannels << " channels, " << out.size() << " bytes"
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "soundbank: " << e.what() << std::endl;
+        status = 1;
+    }
+
+    Mix_CloseAudio();
+    SDL_Quit();
+    return status;
+}